@@ -21,6 +21,7 @@
 #define ADDRFAMILIES_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include <arpa/inet.h>
 #include <sys/socket.h>
@@ -41,6 +42,11 @@ public:
     FamilyInfoBase (uint16_t family, uint8_t bitLength, uint8_t typeSize)
         : _family(family), _bitLength(bitLength), _typeSize(typeSize) {}
 
+    /**
+     * Destructor.
+     */
+    virtual ~FamilyInfoBase() {}
+
     /**
      * Returns address family.
      * @return Address family.
@@ -54,7 +60,7 @@ public:
      * @return Number of bits for address of this family.
      */
     inline uint16_t getAddrBitLength() const {
-        return _family;
+        return _bitLength;
     }
 
     /**
@@ -97,13 +103,81 @@ public:
  */
 struct IPv4AddrFamily: public FamilyInfo<struct in_addr> {
 public:
-    IPv4AddrFamily(): FamilyInfo<struct in_addr>(AF_INET, 32, sizeof(struct in_addr)) {}
+    IPv4AddrFamily(): FamilyInfo<struct in_addr>(AF_INET, BIT_LENGTH, sizeof(struct in_addr)) {}
 
+    typedef uint32_t KeyWord;            /**< Word of the search key, address is walked by its MSB */
+    const static int BIT_LENGTH = 32;    /**< Length of the address in bits */
+    const static int KEY_WORDS = 1;      /**< Number of the key words of the address */
+
+    /**
+     * Returns word of the search key.
+     * @param addr Address as host ordered 32 bit words.
+     * @param word Index of the key word.
+     * @return Key word, first bit of the word is its MSB.
+     */
+    static inline KeyWord getKeyWord(const uint32_t *addr, int word) {
+        return addr[word];
+    }
+
+    /**
+     * Converts address represented as a string into address structure,
+     * invalid address is converted to 0.0.0.0.
+     * @param ip Address as a string.
+     * @param addr Address structure.
+     * @return Address struture.
+     */
     virtual void *ipToAddr(char *ip, void *addr) {
-        inet_pton(AF_INET, ip, addr);
-        *(uint32_t *)addr = ntohl(*(uint32_t *)addr);
+        size_t length = parse(ip, (uint32_t *)addr);
+        if ((length == 0) || (ip[length] != '\0')) {
+            *(uint32_t *)addr = 0;
+        }
         return addr;
     }
+
+    /**
+     * Parses dotted-quad address at the beginning of the string in one pass,
+     * accepts the same addresses as inet_pton(). Parsing stops on the first
+     * character behind the address, so the caller checks the terminator.
+     * @param ip String beginning with the address.
+     * @param addr Host ordered 32 bit word where should be address stored.
+     * @return Number of the parsed characters, or 0 if there is no valid address.
+     */
+    static inline size_t parse(const char *ip, uint32_t *addr) {
+        const char *pos = ip;
+        uint32_t value = 0;
+
+        for (int octet = 0; octet < 4; octet++) {
+            if ((octet != 0) && (*pos++ != '.')) {
+                return 0;
+            }
+
+            uint32_t number = (unsigned char)*pos - '0';
+            if (number > 9) {
+                return 0;
+            }
+            pos++;
+
+            // At most 3 digits, leading zeros are not allowed
+            for (int i = 1; i < 3; i++) {
+                uint32_t digit = (unsigned char)*pos - '0';
+                if (digit > 9) {
+                    break;
+                } else if (number == 0) {
+                    return 0;
+                }
+                number = number * 10 + digit;
+                pos++;
+            }
+
+            if (number > 255) {
+                return 0;
+            }
+            value = (value << 8) | number;
+        }
+
+        *addr = value;
+        return pos - ip;
+    }
 };
 
 /**
@@ -111,15 +185,140 @@ public:
  */
 struct IPv6AddrFamily: public FamilyInfo<struct in6_addr> {
 public:
-    IPv6AddrFamily(): FamilyInfo<struct in6_addr>(AF_INET6, 128, sizeof(struct in6_addr)) {}
+    IPv6AddrFamily(): FamilyInfo<struct in6_addr>(AF_INET6, BIT_LENGTH, sizeof(struct in6_addr)) {}
+
+    typedef uint64_t KeyWord;            /**< Word of the search key, address is walked by its MSB */
+    const static int BIT_LENGTH = 128;   /**< Length of the address in bits */
+    const static int KEY_WORDS = 2;      /**< Number of the key words of the address */
+
+    /**
+     * Returns word of the search key.
+     * @param addr Address as host ordered 32 bit words.
+     * @param word Index of the key word.
+     * @return Key word, first bit of the word is its MSB.
+     */
+    static inline KeyWord getKeyWord(const uint32_t *addr, int word) {
+        return ((uint64_t)addr[2 * word] << 32) | addr[2 * word + 1];
+    }
 
+    /**
+     * Converts address represented as a string into address structure,
+     * invalid address is converted to ::.
+     * @param ip Address as a string.
+     * @param addr Address structure.
+     * @return Address struture.
+     */
     virtual void *ipToAddr(char *ip, void *addr) {
-        inet_pton(AF_INET6, ip, addr);
+        uint32_t *words = (uint32_t *)addr;
+
+        size_t length = parse(ip, words);
+        if ((length == 0) || (ip[length] != '\0')) {
+            words[0] = words[1] = words[2] = words[3] = 0;
+        }
+        return addr;
+    }
+
+    /**
+     * Parses address at the beginning of the string in one pass, accepts
+     * the same addresses as inet_pton() including "::" and embedded IPv4.
+     * Parsing stops on the first character behind the address, so the caller
+     * checks the terminator.
+     * @param ip String beginning with the address.
+     * @param addr Four host ordered 32 bit words where should be address stored.
+     * @return Number of the parsed characters, or 0 if there is no valid address.
+     */
+    static inline size_t parse(const char *ip, uint32_t *addr) {
+        uint32_t groups[8];
+        int count = 0;
+        int gap = -1;          // Index of the group where "::" stands
+        const char *pos = ip;
+
+        if (*pos == ':') {     // Address can start only by "::"
+            if (pos[1] != ':') {
+                return 0;
+            }
+            gap = 0;
+            pos += 2;
+        }
+
+        while ((count < 8) && (hexValue(*pos) < 16)) {
+            const char *group = pos;
+            uint32_t value = 0;
+            uint32_t digit;
+
+            while (((digit = hexValue(*pos)) < 16) && (pos - group < 4)) {
+                value = (value << 4) | digit;
+                pos++;
+            }
+
+            if (*pos == '.') { // Embedded IPv4 address ends the address
+                uint32_t ipv4;
+                size_t length = (count <= 6) ? IPv4AddrFamily::parse(group, &ipv4) : 0;
+                if (length == 0) {
+                    return 0;
+                }
+                groups[count++] = ipv4 >> 16;
+                groups[count++] = ipv4 & 0xFFFF;
+                pos = group + length;
+                break;
+            } else if (digit < 16) {  // Group longer than 4 digits
+                return 0;
+            }
+            groups[count++] = value;
+
+            if ((*pos != ':') || (count == 8)) {
+                break;
+            } else if (pos[1] == ':') {
+                if (gap != -1) {
+                    return 0;
+                }
+                gap = count;
+                pos += 2;
+            } else if (hexValue(pos[1]) < 16) {
+                pos++;
+            } else {
+                return 0;
+            }
+        }
+
+        /* Groups behind "::" are moved to the end, zeros are filled in the gap. */
+        if (gap == -1) {
+            if (count != 8) {
+                return 0;
+            }
+        } else {
+            if (count == 8) {
+                return 0;
+            }
+            int moved = count - gap;
+            for (int i = 1; i <= moved; i++) {
+                groups[8 - i] = groups[count - i];
+            }
+            for (int i = gap; i < 8 - moved; i++) {
+                groups[i] = 0;
+            }
+        }
+
         for (int i = 0; i < 4; i++) {
-            ((uint32_t *)addr)[i] = ntohl(((uint32_t *)addr)[i]);
+            addr[i] = (groups[2 * i] << 16) | groups[2 * i + 1];
         }
+        return pos - ip;
+    }
 
-        return addr;
+private:
+    /**
+     * Converts hexadecimal digit into its value.
+     * @param c Character of the digit.
+     * @return Value of the digit, or 16 if the character is not hexadecimal digit.
+     */
+    static inline uint32_t hexValue(char c) {
+        uint32_t digit = (unsigned char)c - '0';
+        if (digit <= 9) {
+            return digit;
+        }
+
+        digit = ((unsigned char)c | 0x20) - 'a';  // Lower case
+        return (digit <= 5) ? digit + 10 : 16;
     }
 };
 
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       AddrLookupBase.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing common methods of the lookup engines.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file AddrLookupBase.cpp
+ *
+ * @brief Implements common methods of the lookup engines.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include "AddrLookupBase.h"
+
+const uint32_t AddrLookupBase::NO_ASN;
+
+/**
+ * Constructs lookup engine.
+ * @param familyInfo Informations about addresses which will this engine accept.
+ */
+AddrLookupBase::AddrLookupBase(FamilyInfoBase *familyInfo) : familyInfo(familyInfo)
+{
+    // Allocates space for uint, even it is not necessary, it could be better because no alignment would be used
+    int addrSize = (familyInfo->getTypeSize() / 4) + (familyInfo->getTypeSize() % 4 != 0);
+    _addr = new uint32_t[addrSize]();
+}
+
+/**
+ * Destructor of the engine.
+ */
+AddrLookupBase::~AddrLookupBase()
+{
+    delete[] _addr;
+    delete familyInfo;
+}
+
+/**
+ * Inserts parsed records into engine, records are inserted in order of the slices
+ * and order inside them, so the first of the duplicate prefixes wins.
+ * Default implementation inserts records one by one.
+ * @param slices Records of the address family split into slices.
+ * @param sliceCount Number of the slices.
+ * @param threads Number of the threads which can be used (unused).
+ * @return Number of the inserted records.
+ */
+size_t AddrLookupBase::insertRecords(const vector<PrefixRecord> *slices, size_t sliceCount, int threads) {
+    size_t inserted = 0;
+    (void)threads;
+
+    for (size_t slice = 0; slice < sliceCount; slice++) {
+        for (vector<PrefixRecord>::const_iterator it = slices[slice].begin(); it != slices[slice].end(); ++it) {
+            inserted += insertASN(const_cast<uint32_t *>(it->addr), it->prefix, it->asn);
+        }
+    }
+
+    return inserted;
+}
+
+/**
+ * Completes the engine after the prefixes have been inserted.
+ * Default implementation has nothing to complete, inserted prefixes are searchable at once.
+ */
+void AddrLookupBase::build() {
+}
+
+/**
+ * Inserts new ASN or replaces ASN of the stored prefix.
+ * Default implementation does not support incremental updates.
+ * @param addr Address of the prefix (unused).
+ * @param prefix Length of the prefix (unused).
+ * @param asn Number of the autonomous system (unused).
+ * @return Always false.
+ */
+bool AddrLookupBase::update(uint32_t *addr, int prefix, uint32_t asn) {
+    (void)addr;
+    (void)prefix;
+    (void)asn;
+    return false;
+}
+
+/**
+ * Removes stored prefix.
+ * Default implementation does not support incremental updates.
+ * @param addr Address of the prefix (unused).
+ * @param prefix Length of the prefix (unused).
+ * @return Always false.
+ */
+bool AddrLookupBase::withdraw(uint32_t *addr, int prefix) {
+    (void)addr;
+    (void)prefix;
+    return false;
+}
+
+/**
+ * Searches more addresses at once, engines can overlap memory accesses of the searches.
+ * Default implementation searches addresses one by one.
+ * @param addrs Addresses which should be searched, each has getAddrWords() words.
+ * @param n Number of the addresses.
+ * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+ */
+void AddrLookupBase::longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out) {
+    int words = getAddrWords();
+
+    for (size_t i = 0; i < n; i++) {
+        out[i] = longestPrefixMatch(const_cast<uint32_t *>(&addrs[i * words]));
+    }
+}
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       AddrLookupBase.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines common interface of all lookup engines.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file AddrLookupBase.h
+ *
+ * @brief Defines common interface of all lookup engines.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef ADDRLOOKUPBASE_H
+#define ADDRLOOKUPBASE_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "AddrFamilies.h"
+
+using namespace std;
+
+/**
+ * Statistics about the content and memory usage of the lookup engine.
+ */
+struct LookupStats {
+    size_t prefixes;           /**< Number of stored prefixes */
+    size_t nodes;              /**< Number of allocated nodes (groups, tables) */
+    size_t bytes;              /**< Memory used by the nodes and values */
+    size_t uncompressedNodes;  /**< Nodes of the equivalent bit trie, 0 if the engine does not compress */
+    size_t uncompressedBytes;  /**< Memory of the equivalent bit trie, 0 if the engine does not compress */
+};
+
+/**
+ * Parsed record of the prefix which should be inserted into engine.
+ */
+struct PrefixRecord {
+    uint32_t addr[4];          /**< Address as host ordered 32 bit words, IPv4 uses only first word */
+    uint32_t asn;              /**< Number of the autonomous system */
+    int prefix;                /**< Length of the prefix */
+};
+
+/**
+ * Base class of all lookup engines (bit trie, multibit trie, ...).
+ * Engine stores mapping of the address prefixes to the autonomous systems
+ * and performs longest prefix match over them.
+ */
+class AddrLookupBase
+{
+public:
+	/**
+	 * Constructs lookup engine.
+	 * @param familyInfo Informations about addresses which will this engine accept.
+	 */
+    AddrLookupBase(FamilyInfoBase *familyInfo);
+
+    /**
+     * Destructor of the engine.
+     */
+    virtual ~AddrLookupBase();
+
+    /**
+     * Inserts new ASN into engine.
+     * @param addrStr Address in string representation which should be inserted.
+     * @param prefix Defines how many bits should be stored into engine.
+     * @param asn Number of the autonomous system to be stored (NO_ASN is not allowed).
+     * @return True if no error occurs, else false.
+     */
+    inline bool insertASN(char *addrStr, int prefix, uint32_t asn) {
+        familyInfo->ipToAddr(addrStr, _addr);
+        return insertASN(_addr, prefix, asn);
+    }
+
+    /**
+     * Inserts new ASN into engine.
+     * @param addr Address which should be inserted.
+     * @param prefix Defines how many bits should be stored into engine.
+     * @param asn Number of the autonomous system to be stored (NO_ASN is not allowed).
+     * @return True if no error occurs, else false.
+     */
+    virtual bool insertASN(uint32_t *addr, int prefix, uint32_t asn) = 0;
+
+    /**
+     * Inserts parsed records into engine, records are inserted in order of the slices
+     * and order inside them, so the first of the duplicate prefixes wins.
+     * Engines can build the table by more threads.
+     * @param slices Records of the address family split into slices.
+     * @param sliceCount Number of the slices.
+     * @param threads Number of the threads which can be used.
+     * @return Number of the inserted records.
+     */
+    virtual size_t insertRecords(const vector<PrefixRecord> *slices, size_t sliceCount, int threads);
+
+    /**
+     * Completes the engine after the prefixes have been inserted, engines
+     * which derive their structures from all prefixes at once compute them here.
+     * Loader calls it before the engine is searched.
+     */
+    virtual void build();
+
+    /**
+     * Inserts new ASN or replaces ASN of the stored prefix.
+     * Engines which do not support incremental updates return false.
+     * @param addr Address of the prefix.
+     * @param prefix Length of the prefix.
+     * @param asn Number of the autonomous system (NO_ASN is not allowed).
+     * @return True if the prefix has been stored, else false.
+     */
+    virtual bool update(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Removes stored prefix. Engines which do not support incremental updates return false.
+     * @param addr Address of the prefix.
+     * @param prefix Length of the prefix.
+     * @return True if the prefix has been removed, false if it was not stored.
+     */
+    virtual bool withdraw(uint32_t *addr, int prefix);
+
+    /**
+     * Searches address inside the engine and tries to find the corresponding ASN.
+     * @param addrStr Address in string representation which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    inline uint32_t longestPrefixMatch(char *addrStr) {
+        return longestPrefixMatch((uint32_t *)familyInfo->ipToAddr(addrStr, _addr));
+    }
+
+    /**
+     * Searches address inside the engine and tries to find the corresponding ASN.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual uint32_t longestPrefixMatch(uint32_t *addr) = 0;
+
+    /**
+     * Searches more addresses at once, engines can overlap memory accesses of the searches.
+     * @param addrs Addresses which should be searched, each has getAddrWords() words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    virtual void longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out);
+
+    /**
+     * Converts address in string representation into address accepted by the engine.
+     * @param addrStr Address in string representation.
+     * @param addr Space for the address, it has to have getAddrWords() words.
+     * @return Converted address.
+     */
+    inline uint32_t *parseAddr(char *addrStr, uint32_t *addr) {
+        familyInfo->ipToAddr(addrStr, addr);
+        return addr;
+    }
+
+    /**
+     * Returns number of 32 bit words of the address.
+     * @return Number of 32 bit words of the address.
+     */
+    inline int getAddrWords() const {
+        return familyInfo->getAddrBitLength() / 32;
+    }
+
+    /**
+     * Clears all stored prefixes/removes them from the memory.
+     */
+    virtual void clear() = 0;
+
+    /**
+     * Fills statistics about the content and memory usage of the engine.
+     * @param stats Structure which will be filled.
+     */
+    virtual void getStats(LookupStats &stats) const = 0;
+
+    /**
+     * Returns information about family of addresses which are stored inside this engine
+     */
+    inline const FamilyInfoBase &getFamilyInfo() {
+        return *familyInfo;
+    }
+
+    const static uint32_t NO_ASN = 0;  /**< Empty value, AS 0 is reserved and never routed */
+
+protected:
+    FamilyInfoBase *familyInfo;  /**< Stored informations about used address family */
+
+    /**
+     * Returns single bit of the address stored as host ordered 32 bit words.
+     * @param addr Address from which should be bit returned.
+     * @param pos Position of the bit (0 is MSB of the first word).
+     * @return Value of the bit (0 or 1).
+     */
+    static inline int getBit(const uint32_t *addr, int pos) {
+        return (addr[pos >> 5] >> (31 - (pos & 31))) & 1;
+    }
+
+    /**
+     * Extracts bit field from the address stored as host ordered 32 bit words.
+     * @param addr Address from which should be bits extracted.
+     * @param words Number of words of the address.
+     * @param pos Position of the first extracted bit (0 is MSB of the first word).
+     * @param len Number of extracted bits (1-32).
+     * @return Extracted bits aligned to the LSB.
+     */
+    static inline uint32_t extractBits(const uint32_t *addr, int words, int pos, int len) {
+        int word = pos >> 5;
+        uint64_t window = (uint64_t)addr[word] << 32;
+        if (word + 1 < words) {
+            window |= addr[word + 1];
+        }
+        return (uint32_t)((window << (pos & 31)) >> (64 - len));
+    }
+
+private:
+    uint32_t *_addr;            /**< Helper address variable used for computing */
+};
+
+#endif // ADDRLOOKUPBASE_H
@@ -20,19 +20,39 @@
 #define ADDRTRIE_H
 
 #include "AddrTrieBase.h"
+#include "Dir248Table.h"
+#include "FamilyTrie.h"
+#include "LeafPushedTrieBase.h"
+#include "LengthSearchTable.h"
+#include "MultibitTrieBase.h"
+#include "PatriciaTrieBase.h"
+#include "PoptrieBase.h"
 
 /**
  * Templated class of the searching trie which is constructed exactly for the passed Address family.
+ * Engine defines the structure which performs searching (bit trie specialized for the family by default).
  */
-template<class AddrFamily>
-class AddrTrie : public AddrTrieBase {
+template<class AddrFamily, class Engine = FamilyTrie<AddrFamily> >
+class AddrTrie : public Engine {
 public:
 	/**
 	 * Constructs new trie.
 	 */
-    AddrTrie() : AddrTrieBase(new AddrFamily()) {}
+    AddrTrie() : Engine(new AddrFamily()) {}
+
+    /**
+     * Constructs new trie with engine specific parameter.
+     * @param param Parameter passed to the engine (e.g. strides of the multibit trie).
+     */
+    template<typename Param>
+    explicit AddrTrie(Param param) : Engine(new AddrFamily(), param) {}
+
     virtual ~AddrTrie() {}
 
+    using Engine::insertASN;
+    using Engine::longestPrefixMatch;
+    using Engine::longestPrefixMatchBatch;
+
     /**
      * Inserts new ASN into trie.
      * @param addr Address which should be inserted.
@@ -40,17 +60,27 @@ public:
      * @param asn Number of the autonomous system to be stored in destination node.
      * @return True if no error occurs, else false.
      */
-    inline bool insertASN(typename AddrFamily::Addr *addr, int prefix, char *asn) {
-        return AddrTrieBase::insertASN(addr, prefix, asn);
+    inline bool insertASN(typename AddrFamily::Addr *addr, int prefix, uint32_t asn) {
+        return Engine::insertASN((uint32_t *)addr, prefix, asn);
     }
 
     /**
      * Searches through the trie and tries to find the corresponding autonomous system.
      * @param addr Address which should be searched.
-     * @return Found number of the autonomous system on successful searching, or -1 if no address matched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    inline uint32_t longestPrefixMatch(typename AddrFamily::Addr *addr) {
+        return Engine::longestPrefixMatch((uint32_t *)addr);
+    }
+
+    /**
+     * Searches more addresses at once.
+     * @param addrs Addresses which should be searched.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
      */
-    inline char *longestPrefixMatch(typename AddrFamily::Addr *addr) {
-        return AddrTrieBase::longestPrefixMatch(addr);
+    inline void longestPrefixMatchBatch(const typename AddrFamily::Addr *addrs, size_t n, uint32_t *out) {
+        Engine::longestPrefixMatchBatch((const uint32_t *)addrs, n, out);
     }
 };
 
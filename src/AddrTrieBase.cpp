@@ -16,26 +16,58 @@
  * @author Radim Loskot xlosko01(at)stud.fit.vutbr.cz
  */
 
+#include <algorithm>
 #include <cstdlib>
+#include <iterator>
+
+#include <pthread.h>
 
 #include "AddrTrieBase.h"
 
-/*
- * Maximum string length for ASN.
- * 32 bit number (11 characters) + termination character
+const uint32_t AddrTrieBase::ROOT_NODE;
+const size_t AddrTrieBase::BATCH_WAYS;
+const uint32_t AddrTrieBase::NO_NODE;
+const int AddrTrieBase::IPV4_PARTITION_BITS;
+const int AddrTrieBase::IPV6_PARTITION_BITS;
+const int AddrTrieBase::MAX_PREFIX_BITS;
+
+/**
+ * Sets of the ASNs of the nodes computed by the ORTC aggregation. Sets are
+ * sorted and stored one after another in one array, node refers to its set
+ * by the offset and the size.
+ */
+struct AggregationSets {
+    vector<uint32_t> asns;      /**< Sets of all nodes */
+    vector<uint32_t> offsets;   /**< Offset of the set indexed by the node */
+    vector<uint32_t> sizes;     /**< Size of the set indexed by the node */
+    vector<uint32_t> scratch;   /**< Set which is being computed */
+};
+
+/**
+ * Builder of the subtries of the continuous range of partitions, used by one thread of the parallel build.
  */
-const int AddrTrieBase::ASN_STR_MAXLEN = 11;
+struct SubtrieBuilder {
+    const vector<PrefixRecord> *slices; /**< Records split into slices */
+    size_t sliceCount;                  /**< Number of the slices */
+    int words;                          /**< Number of 32 bit words of the address */
+    int partitionBits;                  /**< Number of the partition bits */
+    uint32_t firstPartition;            /**< First partition of the range */
+    uint32_t endPartition;              /**< Partition behind the range */
+    NodePool<TrieNode> nodes;           /**< Pool with nodes of all subtries */
+    vector<uint32_t> roots;             /**< Roots of the subtries indexed from the first partition */
+    size_t inserted;                    /**< Number of the inserted records */
+    size_t rejected;                    /**< Number of the records rejected as duplicates */
+    pthread_t thread;                   /**< Thread which builds the subtries */
+};
 
 /**
  * Constructs address search trie.
  * @param familyInfo Informations about addresses which will this trie accept.
  */
-AddrTrieBase::AddrTrieBase(FamilyInfoBase *familyInfo) : familyInfo(familyInfo)
+AddrTrieBase::AddrTrieBase(FamilyInfoBase *familyInfo)
+    : AddrLookupBase(familyInfo), _prefixCount(0)
 {
-    rootNode = new TrieNode();
-    // Allocates space for uint, even it is not necessary, it could be better because no alignment would be used
-    int addrSize = (familyInfo->getTypeSize() / 4) + (familyInfo->getTypeSize() % 4 != 0);
-    _addr = new uint32_t[addrSize]();
+    _nodes.allocate();  // Root node
 }
 
 /**
@@ -43,33 +75,445 @@ AddrTrieBase::AddrTrieBase(FamilyInfoBase *familyInfo) : familyInfo(familyInfo)
  */
 AddrTrieBase::~AddrTrieBase()
 {
-    clear();
-    delete[] _addr;
-    delete familyInfo;
 }
 
 /**
  * Clears all trie/removes from the memory.
+ * Nodes are freed at once, root node is created again.
  */
 void AddrTrieBase::clear() {
-    clearProtected(rootNode);
-    rootNode = 0;
+    _nodes.clear();
+    _prefixCount = 0;
+
+    _nodes.allocate();
+}
+
+/**
+ * Serves the trie from the external read-only array of the nodes (e.g. mapped
+ * snapshot), nodes are used directly. Trie cannot be modified until it is cleared.
+ * @param nodes Array with the nodes, root is the first one.
+ * @param count Number of the nodes.
+ * @param prefixCount Number of the prefixes stored in the nodes.
+ */
+void AddrTrieBase::attachNodes(const TrieNode *nodes, uint32_t count, size_t prefixCount) {
+    _nodes.attach(nodes, count);
+    _prefixCount = prefixCount;
+}
+
+/**
+ * Inserts new ASN or replaces ASN of the stored prefix.
+ * @param addr Address of the prefix.
+ * @param prefix Length of the prefix.
+ * @param asn Number of the autonomous system (NO_ASN is not allowed).
+ * @return True if the prefix has been stored, else false.
+ */
+bool AddrTrieBase::update(uint32_t *addr, int prefix, uint32_t asn) {
+    if ((prefix < 0) || (prefix > familyInfo->getAddrBitLength()) || (asn == NO_ASN)) {
+        return false;
+    }
+
+    _nodes.detach();
+    TrieNode &node = _nodes[createPath(_nodes, ROOT_NODE, addr, 0, prefix)];
+    if (node.getValue() == NO_ASN) {
+        _prefixCount++;
+    }
+    node.setValue(asn);
+
+    return true;
+}
+
+/**
+ * Removes stored prefix, nodes which have neither value nor children
+ * afterwards are unlinked from the path and released for reuse.
+ * @param addr Address of the prefix.
+ * @param prefix Length of the prefix.
+ * @return True if the prefix has been removed, false if it was not stored.
+ */
+bool AddrTrieBase::withdraw(uint32_t *addr, int prefix) {
+    uint32_t path[MAX_PREFIX_BITS + 1];   // Nodes of the path, root is the first one
+
+    if ((prefix < 0) || (prefix > familyInfo->getAddrBitLength())) {
+        return false;
+    }
+
+    path[0] = ROOT_NODE;
+    for (int i = 0; i < prefix; i++) {
+        path[i + 1] = getBit(addr, i) ? _nodes[path[i]].getRightChild() : _nodes[path[i]].getLeftChild();
+        if (path[i + 1] == 0) {      // Prefix is not stored
+            return false;
+        }
+    }
+
+    if (_nodes[path[prefix]].getValue() == NO_ASN) {
+        return false;
+    }
+
+    _nodes.detach();
+    _nodes[path[prefix]].setValue(NO_ASN);
+    _prefixCount--;
+
+    /* Empty leaves are pruned bottom up, root always stays */
+    for (int i = prefix; i > 0; i--) {
+        const TrieNode &node = _nodes[path[i]];
+        if ((node.getValue() != NO_ASN) || (node.getLeftChild() != 0) || (node.getRightChild() != 0)) {
+            break;
+        }
+
+        if (getBit(addr, i - 1)) {
+            _nodes[path[i - 1]].setRightChild(0);
+        } else {
+            _nodes[path[i - 1]].setLeftChild(0);
+        }
+        _nodes.release(path[i]);
+    }
+
+    return true;
+}
+
+/**
+ * Fills statistics about the content and memory usage of the trie.
+ * @param stats Structure which will be filled.
+ */
+void AddrTrieBase::getStats(LookupStats &stats) const {
+    stats.prefixes = _prefixCount;
+    stats.nodes = _nodes.size() - _nodes.getFreeCount();
+    stats.bytes = _nodes.getBytes();
+    stats.uncompressedNodes = 0;
+    stats.uncompressedBytes = 0;
+}
+
+/**
+ * Counts nodes reachable from the root at each depth and stored prefixes of each length.
+ * @param depthNodes Filled with the number of the nodes indexed by the depth.
+ * @param prefixLengths Filled with the number of the prefixes indexed by the length.
+ */
+void AddrTrieBase::getShape(vector<size_t> &depthNodes, vector<size_t> &prefixLengths) const {
+    const TrieNode *nodes = _nodes.getNodes();
+    vector<pair<uint32_t, int> > stack(1, make_pair(ROOT_NODE, 0));
+
+    depthNodes.assign(familyInfo->getAddrBitLength() + 1, 0);
+    prefixLengths.assign(familyInfo->getAddrBitLength() + 1, 0);
+
+    while (!stack.empty()) {
+        uint32_t node = stack.back().first;
+        int depth = stack.back().second;
+        stack.pop_back();
+
+        depthNodes[depth]++;
+        if (nodes[node].getValue() != NO_ASN) {
+            prefixLengths[depth]++;
+        }
+        for (int bit = 0; bit < 2; bit++) {
+            if (nodes[node].getChild(bit) != ROOT_NODE) {
+                stack.push_back(make_pair(nodes[node].getChild(bit), depth + 1));
+            }
+        }
+    }
+}
+
+/**
+ * Computes the smallest set of the prefixes which gives the same ASN for every
+ * address as the stored prefixes (ORTC aggregation). Missing child of the node
+ * is taken as leaf with the ASN covering the node, so every node has two
+ * children (leaf pushing is not materialized). Sets of the ASNs which
+ * need the fewest prefixes are computed bottom up, ASNs are then chosen top
+ * down and prefix is emitted only where the chosen ASN differs from the one
+ * covering the node. Addresses without match cannot be expressed by prefix,
+ * so subtrie with any of them keeps no prefix at its root.
+ * @param records Filled with the prefixes of the smallest set.
+ * @return Number of the nodes of the bit trie with the aggregated prefixes.
+ */
+size_t AddrTrieBase::aggregate(vector<PrefixRecord> &records) const {
+    AggregationSets sets;
+    uint32_t addr[4] = {0, 0, 0, 0};
+
+    sets.offsets.resize(_nodes.size());
+    sets.sizes.resize(_nodes.size());
+    collectSets(sets, ROOT_NODE, 0, NO_ASN);
+
+    records.clear();
+    size_t nodes = emitPrefixes(sets, ROOT_NODE, 0, NO_ASN, NO_ASN, addr, records);
+    return (nodes == 0) ? 1 : nodes;    // Root is always allocated
+}
+
+/**
+ * Computes sets of the ASNs which can be assigned to the subtrie, so that the
+ * subtrie needs the fewest prefixes. Set is the intersection of the sets of
+ * the children, or their union if they have nothing in common.
+ * @param sets Sets of the nodes which will be filled.
+ * @param node Index of the root node of the subtrie.
+ * @param depth Depth of the node.
+ * @param inherited ASN of the longest stored prefix above the node, or NO_ASN.
+ */
+void AddrTrieBase::collectSets(AggregationSets &sets, uint32_t node, int depth, uint32_t inherited) const {
+    const TrieNode *nodes = _nodes.getNodes();
+    uint32_t value = (nodes[node].getValue() != NO_ASN) ? nodes[node].getValue() : inherited;
+    vector<uint32_t> &set = sets.scratch;
+
+    set.clear();
+    if (depth == familyInfo->getAddrBitLength()) {
+        set.push_back(value);
+    } else {
+        uint32_t children[2];
+        for (int bit = 0; bit < 2; bit++) {
+            children[bit] = nodes[node].getChild(bit);
+            if (children[bit] != ROOT_NODE) {
+                collectSets(sets, children[bit], depth + 1, value);
+            }
+        }
+
+        // Sets of the children are complete, so the array is not reallocated until this set is stored
+        const uint32_t *begins[2], *ends[2];
+        for (int bit = 0; bit < 2; bit++) {
+            if (children[bit] == ROOT_NODE) {  // Leaf pushed from the node
+                begins[bit] = &value;
+                ends[bit] = &value + 1;
+            } else {
+                begins[bit] = &sets.asns[sets.offsets[children[bit]]];
+                ends[bit] = begins[bit] + sets.sizes[children[bit]];
+            }
+        }
+
+        // NO_ASN is the lowest, subtrie with address without match keeps only it
+        set.clear();
+        if ((*begins[0] == NO_ASN) || (*begins[1] == NO_ASN)) {
+            set.push_back(NO_ASN);
+        } else {
+            set_intersection(begins[0], ends[0], begins[1], ends[1], back_inserter(set));
+            if (set.empty()) {
+                set_union(begins[0], ends[0], begins[1], ends[1], back_inserter(set));
+            }
+        }
+    }
+
+    sets.offsets[node] = sets.asns.size();
+    sets.sizes[node] = set.size();
+    sets.asns.insert(sets.asns.end(), set.begin(), set.end());
+}
+
+/**
+ * Chooses ASNs of the subtrie from its sets and emits prefixes where the chosen
+ * ASN differs from the one covering the node. Covering ASN is kept whenever the
+ * set has it.
+ * @param sets Sets of the nodes.
+ * @param node Index of the root node of the subtrie.
+ * @param depth Depth of the node.
+ * @param inherited ASN of the longest stored prefix above the node, or NO_ASN.
+ * @param covering ASN of the longest emitted prefix above the node, or NO_ASN.
+ * @param addr Address of the node, bits behind the depth are 0.
+ * @param records Emitted prefixes.
+ * @return Number of the nodes of the subtrie which hold or lead to the emitted prefixes.
+ */
+size_t AddrTrieBase::emitPrefixes(const AggregationSets &sets, uint32_t node, int depth, uint32_t inherited,
+                                uint32_t covering, uint32_t *addr, vector<PrefixRecord> &records) const {
+    const TrieNode *nodes = _nodes.getNodes();
+    uint32_t value = (nodes[node].getValue() != NO_ASN) ? nodes[node].getValue() : inherited;
+    const uint32_t *set = &sets.asns[sets.offsets[node]];
+    const uint32_t *setEnd = set + sets.sizes[node];
+    PrefixRecord record;
+    size_t count = 0;
+
+    uint32_t chosen = binary_search(set, setEnd, covering) ? covering : *set;
+    if (chosen != covering) {
+        memcpy(record.addr, addr, sizeof(record.addr));
+        record.prefix = depth;
+        record.asn = chosen;
+        records.push_back(record);
+        count = 1;
+    }
+
+    if (depth == familyInfo->getAddrBitLength()) {
+        return count;
+    }
+
+    size_t below = 0;
+    for (int bit = 0; bit < 2; bit++) {
+        uint32_t child = nodes[node].getChild(bit);
+        uint32_t mask = bit ? 0x80000000 >> (depth & 31) : 0;
+
+        addr[depth >> 5] |= mask;
+        if (child != ROOT_NODE) {
+            below += emitPrefixes(sets, child, depth + 1, value, chosen, addr, records);
+        } else if (value != chosen) {         // Pushed leaf differs from the chosen ASN
+            memcpy(record.addr, addr, sizeof(record.addr));
+            record.prefix = depth + 1;
+            record.asn = value;
+            records.push_back(record);
+            below++;
+        }
+        addr[depth >> 5] &= ~mask;
+    }
+
+    return (below == 0) ? count : below + 1;
+}
+
+/**
+ * Inserts parsed records into trie. Records of the prefixes longer than
+ * the partition bits are split by the partition bits into disjoint subtries
+ * which are built by more threads and stitched under the root afterwards.
+ * Shorter prefixes are inserted one by one at the end.
+ * @param slices Records of the address family split into slices.
+ * @param sliceCount Number of the slices.
+ * @param threads Number of the threads which can be used.
+ * @return Number of the inserted records.
+ */
+size_t AddrTrieBase::insertRecords(const vector<PrefixRecord> *slices, size_t sliceCount, int threads) {
+    int bitLength = familyInfo->getAddrBitLength();
+    int partitionBits = (bitLength == 32) ? IPV4_PARTITION_BITS : IPV6_PARTITION_BITS;
+    uint32_t partitions = 1U << partitionBits;
+    int words = getAddrWords();
+
+    // Subtries could be stitched only into the empty trie
+    if ((threads < 2) || (_prefixCount != 0) || (_nodes.size() != 1) || _nodes.isAttached()) {
+        return AddrLookupBase::insertRecords(slices, sliceCount, threads);
+    }
+
+    /* Counts records of the partitions, so the threads get ranges with similar number of records */
+    vector<size_t> histogram(partitions, 0);
+    size_t total = 0;
+    size_t rejected = 0;
+    for (size_t slice = 0; slice < sliceCount; slice++) {
+        for (vector<PrefixRecord>::const_iterator it = slices[slice].begin(); it != slices[slice].end(); ++it) {
+            if ((it->prefix >= partitionBits) && (it->prefix <= bitLength)) {
+                histogram[extractBits(it->addr, words, 0, partitionBits)]++;
+                total++;
+            } else if (it->prefix > bitLength) {  // Rejected the same as by insertASN()
+                rejected++;
+            }
+        }
+    }
+
+    SubtrieBuilder *builders = new SubtrieBuilder[threads];
+    uint32_t partition = 0;
+    size_t assigned = 0;
+    for (int i = 0; i < threads; i++) {
+        SubtrieBuilder &builder = builders[i];
+        size_t target = total * (i + 1) / threads;
+
+        builder.firstPartition = partition;
+        while ((partition < partitions) && ((assigned < target) || (i == threads - 1))) {
+            assigned += histogram[partition++];
+        }
+        builder.endPartition = partition;
+
+        builder.slices = slices;
+        builder.sliceCount = sliceCount;
+        builder.words = words;
+        builder.partitionBits = partitionBits;
+        builder.roots.assign(builder.endPartition - builder.firstPartition, NO_NODE);
+        builder.inserted = 0;
+        builder.rejected = 0;
+        pthread_create(&builder.thread, NULL, buildSubtries, &builder);
+    }
+
+    size_t inserted = 0;
+    for (int i = 0; i < threads; i++) {
+        pthread_join(builders[i].thread, NULL);
+        stitchSubtries(builders[i].nodes, builders[i].roots, builders[i].firstPartition, partitionBits);
+        inserted += builders[i].inserted;
+        rejected += builders[i].rejected;
+    }
+    delete[] builders;
+    _prefixCount += inserted;
+
+    // Builders do not merge their counters, so they are counted here as by insertASN()
+    LPM_STATS_ADD(inserts[RuntimeStats::family(bitLength)], inserted);
+    LPM_STATS_ADD(rejected[RuntimeStats::family(bitLength)], rejected);
+
+    /* Short prefixes lie on the paths above the subtries */
+    for (size_t slice = 0; slice < sliceCount; slice++) {
+        for (vector<PrefixRecord>::const_iterator it = slices[slice].begin(); it != slices[slice].end(); ++it) {
+            if (it->prefix < partitionBits) {
+                inserted += insertASN(const_cast<uint32_t *>(it->addr), it->prefix, it->asn);
+            }
+        }
+    }
+
+    return inserted;
+}
+
+/**
+ * Entry point of the thread which builds subtries of the partition range.
+ * @param builderPtr Builder with the records and the partition range.
+ * @return Always NULL.
+ */
+void *AddrTrieBase::buildSubtries(void *builderPtr) {
+    SubtrieBuilder &builder = *static_cast<SubtrieBuilder *>(builderPtr);
+    int bitLength = builder.words * 32;
+
+    for (size_t slice = 0; slice < builder.sliceCount; slice++) {
+        for (vector<PrefixRecord>::const_iterator it = builder.slices[slice].begin(); it != builder.slices[slice].end(); ++it) {
+            if ((it->prefix < builder.partitionBits) || (it->prefix > bitLength)) {
+                continue;
+            }
+
+            uint32_t partition = extractBits(it->addr, builder.words, 0, builder.partitionBits);
+            if ((partition < builder.firstPartition) || (partition >= builder.endPartition)) {
+                continue;
+            }
+
+            uint32_t &root = builder.roots[partition - builder.firstPartition];
+            if (root == NO_NODE) {
+                root = builder.nodes.allocate();
+            }
+            if (insertInto(builder.nodes, root, it->addr, builder.partitionBits, it->prefix, it->asn)) {
+                builder.inserted++;
+            } else {
+                builder.rejected++;
+            }
+        }
+    }
+
+    return NULL;
 }
 
 /**
- * Clears all nodes recursive from the specified node.
- * @param node Node from which should be all other nodes removed.
+ * Copies nodes of the subtries into this trie and links their roots
+ * under the path given by the partition bits.
+ * @param nodes Pool with nodes of the subtries.
+ * @param roots Indices of the subtrie roots for each partition, NO_NODE if there is no subtrie.
+ * @param firstPartition Partition of the first root.
+ * @param partitionBits Number of the partition bits (depth of the subtrie roots).
  */
-void AddrTrieBase::clearProtected(TrieNode *node) {
-    if (node != 0) {
-        clearProtected(node->getLeftChild());
-        clearProtected(node->getRightChild());
+void AddrTrieBase::stitchSubtries(const NodePool<TrieNode> &nodes, const vector<uint32_t> &roots,
+                                  uint32_t firstPartition, int partitionBits) {
+    uint32_t offset = _nodes.append(nodes);
 
-        char *value = static_cast<char *>(node->getValue());
-        if (value != 0) {
-            delete[] value;
+    /* Children of the copied nodes are moved behind the nodes which were already there */
+    for (uint32_t i = offset; i < _nodes.size(); i++) {
+        TrieNode &node = _nodes[i];
+        if (node.getLeftChild() != 0) {
+            node.setLeftChild(node.getLeftChild() + offset);
+        }
+        if (node.getRightChild() != 0) {
+            node.setRightChild(node.getRightChild() + offset);
+        }
+    }
+
+    for (size_t i = 0; i < roots.size(); i++) {
+        if (roots[i] == NO_NODE) {
+            continue;
         }
 
-        delete node;
+        /* Walks the path of the partition bits, the last edge leads to the subtrie root */
+        uint32_t partition = firstPartition + i;
+        uint32_t currNode = ROOT_NODE;
+        for (int bit = partitionBits - 1; bit >= 0; bit--) {
+            bool right = (partition >> bit) & 1;
+            uint32_t childNode = right ? _nodes[currNode].getRightChild() : _nodes[currNode].getLeftChild();
+
+            if (bit == 0) {
+                childNode = roots[i] + offset;
+            } else if (childNode == 0) {
+                childNode = _nodes.allocate();
+            }
+
+            if (right) {
+                _nodes[currNode].setRightChild(childNode);
+            } else {
+                _nodes[currNode].setLeftChild(childNode);
+            }
+            currNode = childNode;
+        }
     }
 }
@@ -21,15 +21,20 @@
 
 #include <cstring>
 
-#include "AddrFamilies.h"
+#include "AddrLookupBase.h"
+#include "NodePool.h"
+#include "RuntimeStats.h"
 #include "TrieNode.h"
 
 using namespace std;
 
+struct SubtrieBuilder;
+struct AggregationSets;
+
 /**
  * CLass of the searching trie.
  */
-class AddrTrieBase
+class AddrTrieBase : public AddrLookupBase
 {
 public:
 	/**
@@ -43,18 +48,8 @@ public:
      */
     virtual ~AddrTrieBase();
 
-    /**
-     * Inserts new ASN into trie.
-     * @param addrStr Address in string representation which should be inserted.
-     * @param prefix Defines how many bits should be stored into trie.
-     * @param asn Number of the autonomous system to be stored in destination node.
-     * @return True if no error occurs, else false.
-     */
-    inline void insertASN(char *addrStr, int prefix, char *asn)
-    {
-        familyInfo->ipToAddr(addrStr, _addr);
-        insertASN(_addr, prefix, asn);
-    }
+    using AddrLookupBase::insertASN;
+    using AddrLookupBase::longestPrefixMatch;
 
     /**
      * Inserts new ASN into trie.
@@ -63,89 +58,84 @@ public:
      * @param asn Number of the autonomous system to be stored in destination node.
      * @return True if no error occurs, else false.
      */
-    inline bool insertASN(uint32_t *addr, int prefix, char *asn) {
-        TrieNode *currNode = rootNode;
-        TrieNode *childNode;
-        register uint32_t ip_seg = 0;
-
-        /* Iterates through all bits in the address. */
-        for (int i = 0; i < prefix; i++) {
-
-            if (i % 32 == 0) {  // New address segment reached, load it into ip_seg
-                ip_seg = *addr;
-            }
-
-            if (ip_seg & 0x80000000) { // MSB is set, then right child node will be used for iteration
-                childNode = currNode->getRightChild();
-                if (childNode == 0) {  // There is no right child yet, create a new one
-                    childNode = new TrieNode();
-                    currNode->setRightChild(childNode);
-                }
-                currNode = childNode;
-            } else {                  // MSB is not set, then left child node will be used for iteration
-                childNode = currNode->getLeftChild();
-                if (childNode == 0) { // There is no left child yet, create a new one
-                    childNode = new TrieNode();
-                    currNode->setLeftChild(childNode);
-                }
-                currNode = childNode;
-            }
-
-            ip_seg <<= 1;       // Shift address segment left - new MSB will be tested in the next iteration
-
-            if (i % 32 == 31) { // End of the segment reached move to the next one
-                addr++;
-            }
+    virtual inline bool insertASN(uint32_t *addr, int prefix, uint32_t asn) {
+        if ((prefix < 0) || (prefix > familyInfo->getAddrBitLength())) {
+            LPM_STATS_ADD(rejected[RuntimeStats::family(familyInfo->getAddrBitLength())], 1);
+            return false;
         }
 
-        if (currNode->getValue() != 0) { // Return fail whether destination node contains some value
+        _nodes.detach();
+        if (!insertInto(_nodes, ROOT_NODE, addr, 0, prefix, asn)) {
+            LPM_STATS_ADD(rejected[RuntimeStats::family(familyInfo->getAddrBitLength())], 1);
             return false;
-        } else {                         // Insert new AS whether destination node is empty
-            char *val = new char[ASN_STR_MAXLEN + 1];
-            strncpy(val, asn, ASN_STR_MAXLEN);
-            currNode->setValue(val);
-            return true;
         }
+
+        _prefixCount++;
+        LPM_STATS_ADD(inserts[RuntimeStats::family(familyInfo->getAddrBitLength())], 1);
+        return true;
     }
 
     /**
-     * Searches address inside the trie and tries to find the corresponding ASN.
-     * @param addrStr Address in string representation which should be searched.
-     * @return Found number of the autonomous system on successful searching, or -1 if no address matched.
+     * Inserts new ASN or replaces ASN of the stored prefix.
+     * @param addr Address of the prefix.
+     * @param prefix Length of the prefix.
+     * @param asn Number of the autonomous system (NO_ASN is not allowed).
+     * @return True if the prefix has been stored, else false.
      */
-    inline char *longestPrefixMatch(char *addrStr) {
-        return longestPrefixMatch((uint32_t *)familyInfo->ipToAddr(addrStr, _addr));
-    }
+    virtual bool update(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Removes stored prefix, nodes which have neither value nor children
+     * afterwards are unlinked from the path and released for reuse.
+     * @param addr Address of the prefix.
+     * @param prefix Length of the prefix.
+     * @return True if the prefix has been removed, false if it was not stored.
+     */
+    virtual bool withdraw(uint32_t *addr, int prefix);
+
+    /**
+     * Inserts parsed records into trie. Records of the prefixes longer than
+     * the partition bits are split by the partition bits into disjoint subtries
+     * which are built by more threads and stitched under the root afterwards.
+     * Shorter prefixes are inserted one by one at the end.
+     * @param slices Records of the address family split into slices.
+     * @param sliceCount Number of the slices.
+     * @param threads Number of the threads which can be used.
+     * @return Number of the inserted records.
+     */
+    virtual size_t insertRecords(const vector<PrefixRecord> *slices, size_t sliceCount, int threads);
 
     /**
      * Searches address inside the trie and tries to find the corresponding ASN.
      * @param addr Address which should be searched.
-     * @return Found number of the autonomous system on successful searching, or -1 if no address matched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
      */
-    inline char *longestPrefixMatch(uint32_t *addr) {
-        TrieNode *currNode = rootNode;
+    virtual inline uint32_t longestPrefixMatch(uint32_t *addr) {
+        const TrieNode *nodes = _nodes.getNodes();
+        const TrieNode *currNode = &nodes[ROOT_NODE];
+        uint32_t childNode;
         register uint32_t ip_seg = 0;
-        char *ret_value = NULL;
+        uint32_t ret_value = currNode->getValue(); // Default route (prefix 0) is stored in the root
+        int bitLength = familyInfo->getAddrBitLength();
+        int i;
 
         /* Iterates through all bits in the address. */
-        for (int i = 0; 1; i++) {
+        for (i = 0; i < bitLength; i++) {
 
             if (i % 32 == 0) {         // New address segment reached, load it into ip_seg
                 ip_seg = *addr;
             }
 
-            if (ip_seg & 0x80000000) { // MSB is et, try to walk through the right child
-                currNode = static_cast<TrieNode *>(currNode->getRightChild());
-            } else {                   // MSB is not set, try to walk through the left child
-                currNode = static_cast<TrieNode *>(currNode->getLeftChild());
-            }
+            childNode = currNode->getChild(ip_seg >> 31); // MSB selects right (1) or left (0) child
 
-            if (currNode == 0) {       // There is no path, return with fail
+            if (childNode == 0) {      // There is no path, return with fail
                 break;
             }
+            currNode = &nodes[childNode];
 
-            if (currNode->getValue() != 0) { // We have found the currently longest corresponding ASN, but continue and try to find a better one
-                ret_value = static_cast<char *>(currNode->getValue());
+            uint32_t value = currNode->getValue();
+            if (value != NO_ASN) {    // We have found the currently longest corresponding ASN, but continue and try to find a better one
+                ret_value = value;
             }
 
             ip_seg <<= 1;             // Shift address segment left - new MSB will be tested in the next iteration
@@ -155,35 +145,251 @@ public:
             }
         }
 
+        LPM_STATS_WALK(bitLength, i, ret_value);
         return ret_value;            // Found ASN
     }
 
     /**
-     * Returns information about family of addresses which are stored inside this trie
+     * Searches more addresses at once. Walks of the BATCH_WAYS addresses advance
+     * in lockstep, next node of every walk is prefetched and read one round later,
+     * so the memory accesses of the walks overlap.
+     * @param addrs Addresses which should be searched, each has getAddrWords() words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
      */
-    inline const FamilyInfoBase &getFamilyInfo() {
-        return *familyInfo;
+    virtual inline void longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out) {
+        const TrieNode *nodes = _nodes.getNodes();
+        int bitLength = familyInfo->getAddrBitLength();
+        int words = getAddrWords();
+        uint32_t currNodes[BATCH_WAYS];    // ROOT_NODE marks finished walk, no node has it as a child
+
+        for (size_t base = 0; base < n; base += BATCH_WAYS) {
+            size_t ways = (n - base < BATCH_WAYS) ? n - base : BATCH_WAYS;
+            const uint32_t *addr = &addrs[base * words];
+            size_t active = 0;
+
+            /* Default route is stored in the root, first step of every walk is made here */
+            for (size_t w = 0; w < ways; w++) {
+                out[base + w] = nodes[ROOT_NODE].getValue();
+                currNodes[w] = nodes[ROOT_NODE].getChild(getBit(&addr[w * words], 0));
+                if (currNodes[w] != ROOT_NODE) {
+                    __builtin_prefetch(&nodes[currNodes[w]]);
+                    active++;
+                } else {
+                    LPM_STATS_WALK(bitLength, 0, out[base + w]);
+                }
+            }
+
+            /* Every round reads prefetched node of each walk and prefetches its child */
+            for (int i = 1; active > 0; i++) {
+                for (size_t w = 0; w < ways; w++) {
+                    if (currNodes[w] == ROOT_NODE) {
+                        continue;
+                    }
+
+                    const TrieNode *currNode = &nodes[currNodes[w]];
+                    uint32_t value = currNode->getValue();
+                    if (value != NO_ASN) {           // Currently longest corresponding ASN
+                        out[base + w] = value;
+                    }
+
+                    if (i == bitLength) {            // Whole address has been walked through
+                        currNodes[w] = ROOT_NODE;
+                    } else {
+                        currNodes[w] = currNode->getChild(getBit(&addr[w * words], i));
+                    }
+
+                    if (currNodes[w] == ROOT_NODE) { // There is no path, walk is finished
+                        LPM_STATS_WALK(bitLength, i, out[base + w]);
+                        active--;
+                    } else {
+                        __builtin_prefetch(&nodes[currNodes[w]]);
+                    }
+                }
+            }
+        }
     }
 
     /**
      * Clears all trie/removes from the memory.
      */
-    void clear();
+    virtual void clear();
+
+    /**
+     * Fills statistics about the content and memory usage of the trie.
+     * @param stats Structure which will be filled.
+     */
+    virtual void getStats(LookupStats &stats) const;
 
-    const static int ASN_STR_MAXLEN;
+    /**
+     * Counts nodes reachable from the root at each depth and stored prefixes of each length.
+     * @param depthNodes Filled with the number of the nodes indexed by the depth.
+     * @param prefixLengths Filled with the number of the prefixes indexed by the length.
+     */
+    void getShape(vector<size_t> &depthNodes, vector<size_t> &prefixLengths) const;
+
+    /**
+     * Computes the smallest set of the prefixes which gives the same ASN
+     * for every address as the stored prefixes (ORTC aggregation).
+     * @param records Filled with the prefixes of the smallest set.
+     * @return Number of the nodes of the bit trie with the aggregated prefixes.
+     */
+    size_t aggregate(vector<PrefixRecord> &records) const;
+
+    /**
+     * Serves the trie from the external read-only array of the nodes (e.g. mapped
+     * snapshot), nodes are used directly. Nodes are copied on the first modification.
+     * @param nodes Array with the nodes, root is the first one.
+     * @param count Number of the nodes.
+     * @param prefixCount Number of the prefixes stored in the nodes.
+     */
+    void attachNodes(const TrieNode *nodes, uint32_t count, size_t prefixCount);
+
+    /**
+     * Lets the trie be searched by the readers of the domain without locks while
+     * single writer modifies it. Removed nodes and replaced node arrays are
+     * reused or freed after the readers which could see them have left.
+     * @param rcu Domain of the readers, or NULL if the trie is not modified concurrently.
+     */
+    inline void setReclaimDomain(RcuDomain *rcu) {
+        _nodes.setReclaimDomain(rcu);
+    }
+
+    /**
+     * Returns pool with all nodes of the trie.
+     * @return Pool with all nodes of the trie.
+     */
+    inline const NodePool<TrieNode> &getNodePool() const {
+        return _nodes;
+    }
+
+    /**
+     * Returns number of the stored prefixes.
+     * @return Number of the stored prefixes.
+     */
+    inline size_t getPrefixCount() const {
+        return _prefixCount;
+    }
+
+    const static uint32_t ROOT_NODE = 0;  /**< Index of the root node, no node has it as a child */
+    const static size_t BATCH_WAYS = 16;  /**< Number of the walks which advance in lockstep */
+    const static uint32_t NO_NODE = 0xFFFFFFFF; /**< Marks missing subtrie root during parallel build */
+    const static int IPV4_PARTITION_BITS = 8;   /**< Partition bits of the IPv4 parallel build */
+    const static int IPV6_PARTITION_BITS = 16;  /**< Partition bits of the IPv6 parallel build */
+    const static int MAX_PREFIX_BITS = 128;     /**< Length of the longest prefix of all families */
 
 protected:
-    TrieNode *rootNode;          /**< Pointer to root node */
-    FamilyInfoBase *familyInfo;  /**< Stored informations about used address family */
+    NodePool<TrieNode> _nodes;   /**< Pool with all nodes of the trie */
+    size_t _prefixCount;         /**< Number of stored prefixes */
+
+    /**
+     * Inserts new ASN into subtrie of the pool.
+     * @param nodes Pool with nodes of the subtrie.
+     * @param node Index of the root node of the subtrie.
+     * @param addr Address which should be inserted.
+     * @param pos Bit of the address which corresponds to the root of the subtrie.
+     * @param prefix Defines how many bits should be stored into trie.
+     * @param asn Number of the autonomous system to be stored in destination node.
+     * @return True if no error occurs, else false.
+     */
+    static inline bool insertInto(NodePool<TrieNode> &nodes, uint32_t node, const uint32_t *addr,
+                                  int pos, int prefix, uint32_t asn) {
+        uint32_t currNode = createPath(nodes, node, addr, pos, prefix);
+
+        if ((asn == NO_ASN) || (nodes[currNode].getValue() != NO_ASN)) { // Return fail whether destination node contains some value
+            return false;
+        }
+
+        nodes[currNode].setValue(asn);  // Insert new AS whether destination node is empty
+        return true;
+    }
+
+    /**
+     * Walks the path of the prefix inside subtrie of the pool, missing nodes are created.
+     * @param nodes Pool with nodes of the subtrie.
+     * @param node Index of the root node of the subtrie.
+     * @param addr Address of the prefix.
+     * @param pos Bit of the address which corresponds to the root of the subtrie.
+     * @param prefix Length of the prefix.
+     * @return Index of the destination node of the prefix.
+     */
+    static inline uint32_t createPath(NodePool<TrieNode> &nodes, uint32_t node, const uint32_t *addr,
+                                      int pos, int prefix) {
+        uint32_t currNode = node;
+        uint32_t childNode;
+        register uint32_t ip_seg = addr[pos >> 5] << (pos & 31);
+
+        /* Iterates through the rest of the bits in the address. */
+        for (int i = pos; i < prefix; i++) {
+
+            if (i % 32 == 0) {  // New address segment reached, load it into ip_seg
+                ip_seg = addr[i >> 5];
+            }
+
+            if (ip_seg & 0x80000000) { // MSB is set, then right child node will be used for iteration
+                childNode = nodes[currNode].getRightChild();
+                if (childNode == 0) {  // There is no right child yet, create a new one
+                    childNode = nodes.allocate();
+                    nodes[currNode].setRightChild(childNode);
+                }
+                currNode = childNode;
+            } else {                  // MSB is not set, then left child node will be used for iteration
+                childNode = nodes[currNode].getLeftChild();
+                if (childNode == 0) { // There is no left child yet, create a new one
+                    childNode = nodes.allocate();
+                    nodes[currNode].setLeftChild(childNode);
+                }
+                currNode = childNode;
+            }
+
+            ip_seg <<= 1;       // Shift address segment left - new MSB will be tested in the next iteration
+        }
+
+        return currNode;
+    }
+
+    /**
+     * Copies nodes of the subtries into this trie and links their roots
+     * under the path given by the partition bits.
+     * @param nodes Pool with nodes of the subtries.
+     * @param roots Indices of the subtrie roots for each partition, NO_NODE if there is no subtrie.
+     * @param firstPartition Partition of the first root.
+     * @param partitionBits Number of the partition bits (depth of the subtrie roots).
+     */
+    void stitchSubtries(const NodePool<TrieNode> &nodes, const vector<uint32_t> &roots,
+                        uint32_t firstPartition, int partitionBits);
 
     /**
-     * Clears all nodes recursive from the specified node.
-     * @param node Node from which should be all other nodes removed.
+     * Computes sets of the ASNs which can be assigned to the subtrie, so that
+     * the subtrie needs the fewest prefixes (second pass of the ORTC).
+     * @param sets Sets of the nodes which will be filled.
+     * @param node Index of the root node of the subtrie.
+     * @param depth Depth of the node.
+     * @param inherited ASN of the longest stored prefix above the node, or NO_ASN.
      */
-    void clearProtected(TrieNode *node);
+    void collectSets(AggregationSets &sets, uint32_t node, int depth, uint32_t inherited) const;
 
-private:
-    uint32_t *_addr;            /**< Helper address variable used for computing */
+    /**
+     * Chooses ASNs of the subtrie from its sets and emits prefixes where the chosen
+     * ASN differs from the one covering the node (third pass of the ORTC).
+     * @param sets Sets of the nodes.
+     * @param node Index of the root node of the subtrie.
+     * @param depth Depth of the node.
+     * @param inherited ASN of the longest stored prefix above the node, or NO_ASN.
+     * @param covering ASN of the longest emitted prefix above the node, or NO_ASN.
+     * @param addr Address of the node, bits behind the depth are 0.
+     * @param records Emitted prefixes.
+     * @return Number of the nodes of the subtrie which hold or lead to the emitted prefixes.
+     */
+    size_t emitPrefixes(const AggregationSets &sets, uint32_t node, int depth, uint32_t inherited,
+                      uint32_t covering, uint32_t *addr, vector<PrefixRecord> &records) const;
+
+    /**
+     * Entry point of the thread which builds subtries of the partition range.
+     * @param builderPtr Builder with the records and the partition range.
+     * @return Always NULL.
+     */
+    static void *buildSubtries(void *builderPtr);
 };
 
 #endif // ADDRTRIEBASE_H
@@ -0,0 +1,60 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       AsnTable.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing table of the interned ASNs.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file AsnTable.cpp
+ *
+ * @brief Implements table of the interned ASNs.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include "AsnTable.h"
+
+/**
+ * Constructs empty table.
+ */
+AsnTable::AsnTable()
+{
+    _asns.push_back(0);
+}
+
+/**
+ * Destructor of the table.
+ */
+AsnTable::~AsnTable()
+{
+    clear();
+}
+
+/**
+ * Returns index of the ASN, ASN is stored into table whether it is not there yet.
+ * @param asn Number of the autonomous system.
+ * @return Index of the ASN (greater than 0).
+ */
+uint32_t AsnTable::intern(uint32_t asn) {
+    map<uint32_t, uint32_t>::iterator it = _indices.find(asn);
+    if (it != _indices.end()) {
+        return it->second;
+    }
+
+    uint32_t index = _asns.size();
+    _asns.push_back(asn);
+    _indices.insert(pair<uint32_t, uint32_t>(asn, index));
+
+    return index;
+}
+
+/**
+ * Removes all ASNs from the table.
+ */
+void AsnTable::clear() {
+    _asns.resize(1);
+    _indices.clear();
+}
@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       AsnTable.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines table of the interned ASNs.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file AsnTable.h
+ *
+ * @brief Defines table of the interned ASNs.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef ASNTABLE_H
+#define ASNTABLE_H
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+using namespace std;
+
+/**
+ * Table which keeps every distinct ASN only once and assigns it compact index.
+ * Index 0 is reserved and means that there is no ASN. Engines which have
+ * less than 32 bits for the value store the index instead of the ASN.
+ */
+class AsnTable
+{
+public:
+    /**
+     * Constructs empty table.
+     */
+    AsnTable();
+
+    /**
+     * Destructor of the table.
+     */
+    ~AsnTable();
+
+    /**
+     * Returns index of the ASN, ASN is stored into table whether it is not there yet.
+     * @param asn Number of the autonomous system.
+     * @return Index of the ASN (greater than 0).
+     */
+    uint32_t intern(uint32_t asn);
+
+    /**
+     * Returns ASN stored under the index.
+     * @param index Index of the ASN.
+     * @return Number of the autonomous system, or 0 for index 0.
+     */
+    inline uint32_t getASN(uint32_t index) const {
+        return _asns[index];
+    }
+
+    /**
+     * Returns number of the stored ASNs.
+     * @return Number of the stored ASNs.
+     */
+    inline size_t size() const {
+        return _asns.size() - 1;
+    }
+
+    /**
+     * Removes all ASNs from the table.
+     */
+    void clear();
+
+private:
+    vector<uint32_t> _asns;           /**< Stored ASNs, index 0 is 0 */
+    map<uint32_t, uint32_t> _indices; /**< Mapping of the ASNs to their indices */
+};
+
+#endif // ASNTABLE_H
@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       BinarySearcher.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing searcher of the binary addresses.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file BinarySearcher.cpp
+ *
+ * @brief Implements searcher of the binary addresses.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <arpa/inet.h>
+
+#include "BinarySearcher.h"
+#include "LineSearcher.h"
+#include "RuntimeStats.h"
+
+const size_t BinarySearcher::BATCH_SIZE;
+
+/**
+ * Constructs searcher, tables are set by setTables().
+ * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+ */
+BinarySearcher::BinarySearcher(bool binaryOutput)
+    : _ipv4Trie(NULL), _ipv6Trie(NULL), _family(4), _remaining(0), _binaryOutput(binaryOutput), _malformed(false)
+{
+}
+
+/**
+ * Searches all complete addresses of the block, incomplete last address is left.
+ * Addresses are converted and searched right inside the block.
+ * @param block Block of the frames, addresses are converted to host order in place.
+ * @param words Number of the 32 bit words in the block.
+ * @param processed Set to the number of the processed words.
+ * @param output Buffer where should be results printed.
+ * @return True if no error occurs, false if output has failed. Searching stops
+ *         behind malformed frame header, see isMalformed().
+ */
+bool BinarySearcher::searchBlock(uint32_t *block, size_t words, size_t &processed, OutputBuffer &output) {
+    size_t pos = 0;
+
+    while (pos < words) {
+        if (_remaining == 0) {
+            /* Start of the frame */
+            uint32_t header = ntohl(block[pos++]);
+            _family = header >> 24;
+            _remaining = header & 0xFFFFFF;
+            if ((_family != 4) && (_family != 6)) {
+                _malformed = true;
+                break;
+            }
+            continue;
+        }
+
+        AddrLookupBase &trie = (_family == 4) ? *_ipv4Trie : *_ipv6Trie;
+        size_t addrWords = trie.getAddrWords();
+        size_t count = (words - pos) / addrWords;
+        if (count > _remaining) {
+            count = _remaining;
+        }
+        if (count > BATCH_SIZE) {
+            count = BATCH_SIZE;
+        }
+        if (count == 0) {       // Address continues in the next block
+            break;
+        }
+
+        uint32_t *addrs = &block[pos];
+        for (size_t i = 0; i < count * addrWords; i++) {
+            addrs[i] = ntohl(addrs[i]);
+        }
+        pos += count * addrWords;
+        _remaining -= count;
+
+        if (!searchBatch(trie, addrs, count, output)) {
+            processed = pos;
+            return false;
+        }
+    }
+
+    processed = pos;
+    return true;
+}
+
+/**
+ * Searches addresses of one batch and prints found ASNs in input order.
+ * Packed ASNs are stored by the lookup right into the output buffer, it holds
+ * only whole 32 bit numbers in this mode, so the position stays aligned.
+ * @param trie Searching trie of the addresses.
+ * @param addrs Addresses converted to host order.
+ * @param count Number of the addresses.
+ * @param output Buffer where should be results printed.
+ * @return True if no error occurs, false if output has failed.
+ */
+bool BinarySearcher::searchBatch(AddrLookupBase &trie, const uint32_t *addrs, size_t count, OutputBuffer &output) {
+    if (!output.reserve(count * (_binaryOutput ? sizeof(uint32_t) : LineSearcher::ASN_LINE_MAXLEN))) {
+        return false;
+    }
+
+    uint32_t *asns = _binaryOutput ? reinterpret_cast<uint32_t *>(output.getPos()) : _asns;
+    LPM_STATS_START(start);
+    trie.longestPrefixMatchBatch(addrs, count, asns);
+    LPM_STATS_PHASE(PHASE_LOOKUP, start);
+
+    LPM_STATS_RESTART(start);
+#ifdef LPM_STATS
+    for (size_t i = 0; i < count; i++) {
+        LPM_STATS_ADD(matchedLines, asns[i] != AddrLookupBase::NO_ASN);
+    }
+#endif
+
+    if (_binaryOutput) {
+        for (size_t i = 0; i < count; i++) {
+            asns[i] = htonl(asns[i]);
+        }
+        output.setPos(output.getPos() + count * sizeof(uint32_t));
+    } else {
+        char *wbuffChar = output.getPos();
+        for (size_t i = 0; i < count; i++) {
+            if (asns[i] == AddrLookupBase::NO_ASN) {
+                *wbuffChar++ = '-';
+            } else {
+                wbuffChar = LineSearcher::formatASN(asns[i], wbuffChar);
+            }
+            *wbuffChar++ = '\n';
+        }
+        output.setPos(wbuffChar);
+    }
+    LPM_STATS_ADD(lines, count);
+    LPM_STATS_PHASE(PHASE_FORMAT, start);
+
+    return true;
+}
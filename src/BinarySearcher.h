@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       BinarySearcher.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines searcher of the binary addresses.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file BinarySearcher.h
+ *
+ * @brief Defines searcher of the binary addresses.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef BINARYSEARCHER_H
+#define BINARYSEARCHER_H
+
+#include <stdint.h>
+
+#include "AddrLookupBase.h"
+#include "OutputBuffer.h"
+
+/**
+ * Searcher of the addresses which are given by binary frames of the server
+ * protocol: 32 bit header in network order with the address family (4 or 6)
+ * in the upper 8 bits and number of the addresses in the lower 24 bits,
+ * followed by the packed addresses in network order. Addresses are converted
+ * in place inside the read block and searched right from it, nothing is
+ * parsed or copied. Results are printed either as lines like for the text
+ * input or as packed 32 bit ASNs in network order, 0 means no match.
+ * Frame may continue in the next block.
+ */
+class BinarySearcher
+{
+public:
+    /**
+     * Constructs searcher, tables are set by setTables().
+     * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+     */
+    BinarySearcher(bool binaryOutput = false);
+
+    /**
+     * Sets tables which are used by the next searching.
+     * @param ipv4Trie Searching trie for IPv4 addresses.
+     * @param ipv6Trie Searching trie for IPv6 addresses.
+     */
+    inline void setTables(AddrLookupBase &ipv4Trie, AddrLookupBase &ipv6Trie) {
+        _ipv4Trie = &ipv4Trie;
+        _ipv6Trie = &ipv6Trie;
+    }
+
+    /**
+     * Searches all complete addresses of the block, incomplete last address is left.
+     * @param block Block of the frames, addresses are converted to host order in place.
+     * @param words Number of the 32 bit words in the block.
+     * @param processed Set to the number of the processed words.
+     * @param output Buffer where should be results printed.
+     * @return True if no error occurs, false if output has failed. Searching stops
+     *         behind malformed frame header, see isMalformed().
+     */
+    bool searchBlock(uint32_t *block, size_t words, size_t &processed, OutputBuffer &output);
+
+    /**
+     * Tells whether the last frame has been received completely.
+     * @return True if no addresses of the frame are missing, else false.
+     */
+    inline bool isComplete() const {
+        return _remaining == 0;
+    }
+
+    /**
+     * Tells whether malformed frame header has been found.
+     * @return True if the input is malformed, else false.
+     */
+    inline bool isMalformed() const {
+        return _malformed;
+    }
+
+    const static size_t BATCH_SIZE = 4096;    /**< Number of the addresses which are searched at once */
+
+private:
+    AddrLookupBase *_ipv4Trie;      /**< Searching trie for IPv4 addresses */
+    AddrLookupBase *_ipv6Trie;      /**< Searching trie for IPv6 addresses */
+    uint32_t _asns[BATCH_SIZE];     /**< Found ASNs of the addresses which are printed as lines */
+    int _family;                    /**< Address family of the current frame */
+    uint32_t _remaining;            /**< Addresses of the current frame which have not been searched */
+    bool _binaryOutput;             /**< ASNs are printed as packed 32 bit numbers */
+    bool _malformed;                /**< Malformed frame header has been found */
+
+    /**
+     * Searches addresses of one batch and prints found ASNs in input order.
+     * @param trie Searching trie of the addresses.
+     * @param addrs Addresses converted to host order.
+     * @param count Number of the addresses.
+     * @param output Buffer where should be results printed.
+     * @return True if no error occurs, false if output has failed.
+     */
+    bool searchBatch(AddrLookupBase &trie, const uint32_t *addrs, size_t count, OutputBuffer &output);
+
+    BinarySearcher(const BinarySearcher &);
+    BinarySearcher &operator=(const BinarySearcher &);
+};
+
+#endif // BINARYSEARCHER_H
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       Dir248Table.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing DIR-24-8 lookup table for IPv4.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file Dir248Table.cpp
+ *
+ * @brief Implements DIR-24-8 lookup table for IPv4.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "Dir248Table.h"
+
+const uint32_t Dir248Table::INDEX_MASK;
+const uint32_t Dir248Table::GROUP_FLAG;
+const int Dir248Table::LENGTH_SHIFT;
+
+/**
+ * Number of entries of the first level table.
+ */
+const static size_t TBL24_SIZE = 1 << 24;
+
+/**
+ * Number of entries of the second level group.
+ */
+const static size_t TBL8_GROUP_SIZE = 256;
+
+/**
+ * Number of 32 bit words of the bitmap of the prefixes stored in the group.
+ */
+const static size_t TBL8_PRESENT_WORDS = 2 * TBL8_GROUP_SIZE / 32;
+
+/**
+ * Constructs empty DIR-24-8 table.
+ * @param familyInfo Informations about addresses which will this table accept (IPv4 only).
+ */
+Dir248Table::Dir248Table(FamilyInfoBase *familyInfo)
+    : AddrLookupBase(familyInfo), _present24(2 * TBL24_SIZE / 32), _prefixCount(0)
+{
+    // calloc() gets zeroed pages lazily from the system, so untouched parts of the table cost nothing
+    _tbl24 = static_cast<uint32_t *>(calloc(TBL24_SIZE, sizeof(uint32_t)));
+    if (_tbl24 == NULL) {
+        throw bad_alloc();
+    }
+}
+
+/**
+ * Destructor of the table.
+ */
+Dir248Table::~Dir248Table()
+{
+    free(_tbl24);
+}
+
+/**
+ * Inserts new ASN into table.
+ * @param addr Address which should be inserted.
+ * @param prefix Defines how many bits should be stored into table.
+ * @param asn Number of the autonomous system to be stored in destination entries.
+ * @return True if no error occurs, else false.
+ */
+bool Dir248Table::insertASN(uint32_t *addr, int prefix, uint32_t asn) {
+    uint32_t ip = *addr;
+    uint32_t *entries;
+    uint32_t *present;
+    uint32_t bit;
+    uint32_t count;
+
+    if ((prefix < 0) || (prefix > 32) || (asn == NO_ASN)) {
+        return false;
+    }
+
+    if (prefix <= 24) {       // Prefix is expanded directly into the first level
+        count = 1 << (24 - prefix);
+        entries = &_tbl24[(ip >> 8) & ~(count - 1)];
+        present = &_present24[0];
+        bit = (1 << prefix) | ((ip >> 8) >> (24 - prefix));
+    } else {                  // Prefix is expanded into the second level group
+        uint32_t *entry = &_tbl24[ip >> 8];
+
+        if (!(*entry & GROUP_FLAG)) { // There is no group yet, create a new one inheriting shorter prefix
+            uint32_t group = _tbl8.size() / TBL8_GROUP_SIZE;
+            if (group > INDEX_MASK) {
+                return false;
+            }
+            _tbl8.insert(_tbl8.end(), TBL8_GROUP_SIZE, *entry);
+            _present8.insert(_present8.end(), TBL8_PRESENT_WORDS, 0);
+            *entry = GROUP_FLAG | group;
+        }
+
+        count = 1 << (32 - prefix);
+        entries = &_tbl8[((*entry & INDEX_MASK) * TBL8_GROUP_SIZE) + ((ip & 0xFF) & ~(count - 1))];
+        present = &_present8[(*entry & INDEX_MASK) * TBL8_PRESENT_WORDS];
+        bit = (1 << (prefix - 24)) | ((ip & 0xFF) >> (32 - prefix));
+    }
+
+    // Prefix which is already stored can be shadowed by longer prefixes, so it is looked up in the bitmap
+    if (present[bit >> 5] & (1U << (bit & 31))) {
+        return false;
+    }
+
+    uint32_t index = _asns.intern(asn);
+    if (index > INDEX_MASK) {
+        return false;
+    }
+
+    present[bit >> 5] |= 1U << (bit & 31);
+    fillRange(entries, count, prefix, ((uint32_t)prefix << LENGTH_SHIFT) | index);
+    _prefixCount++;
+
+    return true;
+}
+
+/**
+ * Stores ASN into all entries of the range which are not covered by longer prefix.
+ * @param entries First entry of the range.
+ * @param count Number of entries in the range.
+ * @param prefix Length of the inserted prefix.
+ * @param value Entry value with ASN index and prefix length.
+ */
+void Dir248Table::fillRange(uint32_t *entries, uint32_t count, int prefix, uint32_t value) {
+    for (uint32_t *entry = entries; entry != entries + count; entry++) {
+        if (*entry & GROUP_FLAG) {   // Prefix covers the whole group, fill it too
+            fillRange(&_tbl8[(*entry & INDEX_MASK) * TBL8_GROUP_SIZE], TBL8_GROUP_SIZE, prefix, value);
+        } else if (((*entry & INDEX_MASK) == 0) || ((int)(*entry >> LENGTH_SHIFT) < prefix)) {
+            *entry = value;
+        }
+    }
+}
+
+/**
+ * Clears all table/removes from the memory.
+ */
+void Dir248Table::clear() {
+    free(_tbl24);
+    _tbl24 = static_cast<uint32_t *>(calloc(TBL24_SIZE, sizeof(uint32_t)));
+    if (_tbl24 == NULL) {
+        throw bad_alloc();
+    }
+
+    _tbl8.clear();
+    _present8.clear();
+    _present24.assign(_present24.size(), 0);
+    _asns.clear();
+    _prefixCount = 0;
+}
+
+/**
+ * Fills statistics about the content and memory usage of the table.
+ * @param stats Structure which will be filled, nodes are the second level groups.
+ */
+void Dir248Table::getStats(LookupStats &stats) const {
+    stats.prefixes = _prefixCount;
+    stats.nodes = _tbl8.size() / TBL8_GROUP_SIZE;
+    stats.bytes = (TBL24_SIZE + _tbl8.size() + _present24.size() + _present8.size()) * sizeof(uint32_t)
+                  + _asns.size() * sizeof(uint32_t);
+    stats.uncompressedNodes = 0;
+    stats.uncompressedBytes = 0;
+}
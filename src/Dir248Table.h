@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       Dir248Table.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines DIR-24-8 lookup table for IPv4.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file Dir248Table.h
+ *
+ * @brief Defines DIR-24-8 lookup table for IPv4.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef DIR248TABLE_H
+#define DIR248TABLE_H
+
+#include <vector>
+
+#include "AddrLookupBase.h"
+#include "AsnTable.h"
+
+using namespace std;
+
+/**
+ * DIR-24-8 lookup table for IPv4 addresses. First level is directly indexed
+ * by the upper 24 bits of the address, prefixes longer than /24 are stored
+ * in the 256 entries large second level groups. Every lookup costs at most
+ * two memory accesses into the tables.
+ *
+ * Entry of both levels is 32 bit number:
+ *  - bits 0-23  index of the ASN in the ASN table or index of the second level group,
+ *  - bit 24     flag that entry points to the second level group,
+ *  - bits 25-30 length of the prefix which has stored its ASN in the entry.
+ */
+class Dir248Table : public AddrLookupBase
+{
+public:
+    /**
+     * Constructs empty DIR-24-8 table.
+     * @param familyInfo Informations about addresses which will this table accept (IPv4 only).
+     */
+    Dir248Table(FamilyInfoBase *familyInfo);
+
+    /**
+     * Destructor of the table.
+     */
+    virtual ~Dir248Table();
+
+    using AddrLookupBase::insertASN;
+    using AddrLookupBase::longestPrefixMatch;
+
+    /**
+     * Inserts new ASN into table.
+     * @param addr Address which should be inserted.
+     * @param prefix Defines how many bits should be stored into table.
+     * @param asn Number of the autonomous system to be stored in destination entries.
+     * @return True if no error occurs, else false.
+     */
+    virtual bool insertASN(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Searches address inside the table and tries to find the corresponding ASN.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual inline uint32_t longestPrefixMatch(uint32_t *addr) {
+        uint32_t entry = _tbl24[*addr >> 8];
+
+        if (entry & GROUP_FLAG) {    // Prefix longer than /24, look into the second level
+            entry = _tbl8[((entry & INDEX_MASK) << 8) | (*addr & 0xFF)];
+        }
+
+        return _asns.getASN(entry & INDEX_MASK);
+    }
+
+    /**
+     * Searches more addresses at once. First level entries of all addresses
+     * are prefetched before they are read, so their cache misses overlap.
+     * @param addrs Addresses which should be searched.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    virtual inline void longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out) {
+        for (size_t i = 0; i < n; i++) {
+            __builtin_prefetch(&_tbl24[addrs[i] >> 8]);
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            uint32_t entry = _tbl24[addrs[i] >> 8];
+
+            if (entry & GROUP_FLAG) {    // Prefix longer than /24, look into the second level
+                entry = _tbl8[((entry & INDEX_MASK) << 8) | (addrs[i] & 0xFF)];
+            }
+
+            out[i] = _asns.getASN(entry & INDEX_MASK);
+        }
+    }
+
+    /**
+     * Clears all table/removes from the memory.
+     */
+    virtual void clear();
+
+    /**
+     * Fills statistics about the content and memory usage of the table.
+     * @param stats Structure which will be filled, nodes are the second level groups.
+     */
+    virtual void getStats(LookupStats &stats) const;
+
+    /**
+     * Returns table of the ASNs referenced by the entries.
+     * @return Table of the ASNs.
+     */
+    inline const AsnTable &getAsnTable() const {
+        return _asns;
+    }
+
+    const static uint32_t INDEX_MASK = 0x00FFFFFF;  /**< Mask of the ASN/group index */
+    const static uint32_t GROUP_FLAG = 0x01000000;  /**< Flag of the entry pointing to the group */
+    const static int LENGTH_SHIFT = 25;             /**< Position of the prefix length */
+
+protected:
+    /**
+     * Stores ASN into all entries of the range which are not covered by longer prefix.
+     * @param entries First entry of the range.
+     * @param count Number of entries in the range.
+     * @param prefix Length of the inserted prefix.
+     * @param value Entry value with ASN index and prefix length.
+     */
+    void fillRange(uint32_t *entries, uint32_t count, int prefix, uint32_t value);
+
+private:
+    uint32_t *_tbl24;         /**< First level table with 2^24 entries */
+    vector<uint32_t> _tbl8;   /**< Second level groups with 256 entries */
+    vector<uint32_t> _present24;  /**< Bitmap of the stored prefixes up to /24, bit of the prefix is (1 << length) | bits */
+    vector<uint32_t> _present8;   /**< Bitmaps of the prefixes longer than /24 stored in the groups */
+    AsnTable _asns;           /**< Interned ASNs referenced by the entries */
+    size_t _prefixCount;      /**< Number of stored prefixes */
+};
+
+#endif // DIR248TABLE_H
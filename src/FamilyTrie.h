@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       FamilyTrie.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines bit trie specialized for address family.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file FamilyTrie.h
+ *
+ * @brief Defines bit trie specialized for address family.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef FAMILYTRIE_H
+#define FAMILYTRIE_H
+
+#include "AddrTrieBase.h"
+
+/**
+ * Bit trie whose searching is compiled for the address family. Length of the
+ * address and type of the search key are taken from the family at compile
+ * time, so the walk has constant bounds and shifts the key words instead of
+ * extracting bits at runtime positions. IPv4 is walked as one 32 bit word,
+ * IPv6 as two 64 bit words. Nodes, building, updates and snapshots are
+ * shared with AddrTrieBase.
+ *
+ * Walks stay virtual methods of AddrLookupBase, the caller does not
+ * instantiate them. Searching through AddrLookupBase pointer costs one
+ * virtual call per longestPrefixMatchBatch() (used by the line searcher and
+ * the server), but one per address for longestPrefixMatch(). Only caller
+ * which names FamilyTrie (as lpm_bench does) gets the walk inlined.
+ */
+template<class AddrFamily>
+class FamilyTrie : public AddrTrieBase
+{
+public:
+    typedef typename AddrFamily::KeyWord KeyWord;  /**< Word of the search key */
+
+    /**
+     * Constructs trie.
+     * @param familyInfo Informations about addresses, has to be AddrFamily.
+     */
+    FamilyTrie(FamilyInfoBase *familyInfo) : AddrTrieBase(familyInfo) {}
+
+    /**
+     * Destructor of the trie.
+     */
+    virtual ~FamilyTrie() {}
+
+    using AddrTrieBase::longestPrefixMatch;
+
+    /**
+     * Searches address inside the trie and tries to find the corresponding ASN.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual inline uint32_t longestPrefixMatch(uint32_t *addr) {
+        const TrieNode *nodes = _nodes.getNodes();
+        const TrieNode *currNode = &nodes[ROOT_NODE];
+        uint32_t ret_value = currNode->getValue(); // Default route (prefix 0) is stored in the root
+
+        for (int word = 0; word < AddrFamily::KEY_WORDS; word++) {
+            KeyWord key = AddrFamily::getKeyWord(addr, word);
+
+            for (int i = 0; i < KEY_BITS; i++) {
+                uint32_t childNode = currNode->getChild(key >> (KEY_BITS - 1)); // MSB selects the child
+                if (childNode == ROOT_NODE) {  // There is no path
+                    LPM_STATS_WALK(AddrFamily::BIT_LENGTH, word * KEY_BITS + i, ret_value);
+                    return ret_value;
+                }
+                currNode = &nodes[childNode];
+
+                uint32_t value = currNode->getValue();
+                if (value != NO_ASN) {         // Currently longest corresponding ASN
+                    ret_value = value;
+                }
+                key <<= 1;
+            }
+        }
+
+        LPM_STATS_WALK(AddrFamily::BIT_LENGTH, AddrFamily::BIT_LENGTH, ret_value);
+        return ret_value;
+    }
+
+    /**
+     * Searches more addresses at once, walks advance in lockstep and prefetch
+     * their next nodes as in AddrTrieBase. Walks wait for the memory here, so
+     * bits are extracted from 32 bit words whose count is known at compile time.
+     * @param addrs Addresses which should be searched, each has ADDR_WORDS words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    virtual inline void longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out) {
+        const TrieNode *nodes = _nodes.getNodes();
+        uint32_t currNodes[BATCH_WAYS];    // ROOT_NODE marks finished walk, no node has it as a child
+
+        for (size_t base = 0; base < n; base += BATCH_WAYS) {
+            size_t ways = (n - base < BATCH_WAYS) ? n - base : BATCH_WAYS;
+            const uint32_t *addr = &addrs[base * ADDR_WORDS];
+            size_t active = 0;
+
+            /* Default route is stored in the root, first step of every walk is made here */
+            for (size_t w = 0; w < ways; w++) {
+                out[base + w] = nodes[ROOT_NODE].getValue();
+                currNodes[w] = nodes[ROOT_NODE].getChild(addr[w * ADDR_WORDS] >> 31);
+                if (currNodes[w] != ROOT_NODE) {
+                    __builtin_prefetch(&nodes[currNodes[w]]);
+                    active++;
+                } else {
+                    LPM_STATS_WALK(AddrFamily::BIT_LENGTH, 0, out[base + w]);
+                }
+            }
+
+            /* Every round reads prefetched node of each walk and prefetches its child */
+            for (int i = 1; active > 0; i++) {
+                int word = i >> 5;
+                int shift = 31 - (i & 31);
+
+                for (size_t w = 0; w < ways; w++) {
+                    if (currNodes[w] == ROOT_NODE) {
+                        continue;
+                    }
+
+                    const TrieNode *currNode = &nodes[currNodes[w]];
+                    uint32_t value = currNode->getValue();
+                    if (value != NO_ASN) {           // Currently longest corresponding ASN
+                        out[base + w] = value;
+                    }
+
+                    if (i == AddrFamily::BIT_LENGTH) { // Whole address has been walked through
+                        LPM_STATS_WALK(AddrFamily::BIT_LENGTH, i, out[base + w]);
+                        currNodes[w] = ROOT_NODE;
+                        active--;
+                        continue;
+                    }
+
+                    currNodes[w] = currNode->getChild((addr[w * ADDR_WORDS + word] >> shift) & 1);
+
+                    if (currNodes[w] == ROOT_NODE) { // There is no path, walk is finished
+                        LPM_STATS_WALK(AddrFamily::BIT_LENGTH, i, out[base + w]);
+                        active--;
+                    } else {
+                        __builtin_prefetch(&nodes[currNodes[w]]);
+                    }
+                }
+            }
+        }
+    }
+
+    const static int KEY_BITS = sizeof(KeyWord) * 8;              /**< Number of the bits of the key word */
+    const static int ADDR_WORDS = AddrFamily::BIT_LENGTH / 32;    /**< Number of 32 bit words of the address */
+
+private:
+    FamilyTrie(const FamilyTrie &);
+    FamilyTrie &operator=(const FamilyTrie &);
+};
+
+#endif // FAMILYTRIE_H
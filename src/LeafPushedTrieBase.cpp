@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LeafPushedTrieBase.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing leaf-pushed bit trie.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LeafPushedTrieBase.cpp
+ *
+ * @brief Implements leaf-pushed bit trie.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include "LeafPushedTrieBase.h"
+
+/**
+ * Constructs empty trie, its root is leaf without ASN.
+ * @param familyInfo Informations about addresses which will this trie accept.
+ */
+LeafPushedTrieBase::LeafPushedTrieBase(FamilyInfoBase *familyInfo) : AddrTrieBase(familyInfo), _pushed(1)
+{
+}
+
+/**
+ * Destructor of the trie.
+ */
+LeafPushedTrieBase::~LeafPushedTrieBase()
+{
+}
+
+/**
+ * Pushes the leaves from the inserted prefixes. Root has to stay the first
+ * node, so the pushed root (internal node or leaf) is copied over it.
+ */
+void LeafPushedTrieBase::build() {
+    const TrieNode *nodes = _nodes.getNodes();
+
+    _pushed.assign(1, TrieNode());
+    _leaves.clear();
+
+    uint32_t root = pushNode(nodes, ROOT_NODE, NO_ASN);
+    _pushed[ROOT_NODE] = _pushed[root];
+}
+
+/**
+ * Pushes the leaves of the subtrie of the bit trie. Children are pushed
+ * before their parent, equal children can be only the same shared leaf.
+ * @param nodes Nodes of the bit trie.
+ * @param node Root of the subtrie.
+ * @param value ASN of the longest prefix covering the root, or NO_ASN.
+ * @return Index of the pushed node or leaf.
+ */
+uint32_t LeafPushedTrieBase::pushNode(const TrieNode *nodes, uint32_t node, uint32_t value) {
+    if (nodes[node].getValue() != NO_ASN) {
+        value = nodes[node].getValue();
+    }
+
+    uint32_t leftChild = nodes[node].getLeftChild();
+    uint32_t rightChild = nodes[node].getRightChild();
+    uint32_t left = (leftChild != ROOT_NODE) ? pushNode(nodes, leftChild, value) : getLeaf(value);
+    uint32_t right = (rightChild != ROOT_NODE) ? pushNode(nodes, rightChild, value) : getLeaf(value);
+
+    if (left == right) {        // Whole subtrie has the same ASN
+        return left;
+    }
+
+    _pushed.push_back(TrieNode(NO_ASN, left, right));
+    return _pushed.size() - 1;
+}
+
+/**
+ * Returns shared leaf with the ASN, leaf is created when it does not exist.
+ * @param value ASN of the leaf, or NO_ASN.
+ * @return Index of the leaf.
+ */
+uint32_t LeafPushedTrieBase::getLeaf(uint32_t value) {
+    map<uint32_t, uint32_t>::iterator leaf = _leaves.find(value);
+    if (leaf != _leaves.end()) {
+        return leaf->second;
+    }
+
+    _pushed.push_back(TrieNode(value, ROOT_NODE, ROOT_NODE));
+    _leaves[value] = _pushed.size() - 1;
+    return _pushed.size() - 1;
+}
+
+/**
+ * Pushed trie cannot be updated incrementally.
+ * @param addr Address of the prefix (unused).
+ * @param prefix Length of the prefix (unused).
+ * @param asn Number of the autonomous system (unused).
+ * @return Always false.
+ */
+bool LeafPushedTrieBase::update(uint32_t *addr, int prefix, uint32_t asn) {
+    return AddrLookupBase::update(addr, prefix, asn);
+}
+
+/**
+ * Pushed trie cannot be updated incrementally.
+ * @param addr Address of the prefix (unused).
+ * @param prefix Length of the prefix (unused).
+ * @return Always false.
+ */
+bool LeafPushedTrieBase::withdraw(uint32_t *addr, int prefix) {
+    return AddrLookupBase::withdraw(addr, prefix);
+}
+
+/**
+ * Clears all trie/removes from the memory.
+ */
+void LeafPushedTrieBase::clear() {
+    AddrTrieBase::clear();
+    _pushed.assign(1, TrieNode());
+    _leaves.clear();
+}
+
+/**
+ * Fills statistics about the content and memory usage of the trie.
+ * @param stats Structure which will be filled, nodes and memory are of the pushed
+ *              trie, uncompressed nodes and memory are of the source bit trie.
+ */
+void LeafPushedTrieBase::getStats(LookupStats &stats) const {
+    AddrTrieBase::getStats(stats);
+    stats.uncompressedNodes = stats.nodes;
+    stats.uncompressedBytes = stats.nodes * sizeof(TrieNode);  // Used nodes of the bit trie, not capacity of its pool
+    stats.nodes = _pushed.size();
+    stats.bytes = _pushed.size() * sizeof(TrieNode);
+}
@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LeafPushedTrieBase.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines leaf-pushed bit trie.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LeafPushedTrieBase.h
+ *
+ * @brief Defines leaf-pushed bit trie.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef LEAFPUSHEDTRIEBASE_H
+#define LEAFPUSHEDTRIEBASE_H
+
+#include <map>
+#include <vector>
+
+#include "AddrTrieBase.h"
+
+using namespace std;
+
+/**
+ * Bit trie whose values are pushed down into the leaves. Every internal node
+ * has both children and no value, missing child of the bit trie becomes leaf
+ * with the ASN of the longest prefix covering it. Lookup only descends until
+ * the node has no child and reads the value of that leaf, it neither tests
+ * nor remembers values on the path. Nodes are the TrieNode of the bit trie,
+ * leaves with the same ASN are shared by all their parents and internal node
+ * whose both children are the same leaf is replaced by it.
+ *
+ * Prefixes are inserted into the inherited bit trie which stays as the source
+ * of the table, build() pushes the leaves from it. Lookups search only the
+ * pushed trie, prefixes inserted later are searchable after next build().
+ */
+class LeafPushedTrieBase : public AddrTrieBase
+{
+public:
+    /**
+     * Constructs empty trie.
+     * @param familyInfo Informations about addresses which will this trie accept.
+     */
+    LeafPushedTrieBase(FamilyInfoBase *familyInfo);
+
+    /**
+     * Destructor of the trie.
+     */
+    virtual ~LeafPushedTrieBase();
+
+    using AddrTrieBase::insertASN;
+    using AddrTrieBase::longestPrefixMatch;
+
+    /**
+     * Pushes the leaves from the inserted prefixes.
+     */
+    virtual void build();
+
+    /**
+     * Pushed trie cannot be updated incrementally.
+     * @param addr Address of the prefix (unused).
+     * @param prefix Length of the prefix (unused).
+     * @param asn Number of the autonomous system (unused).
+     * @return Always false.
+     */
+    virtual bool update(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Pushed trie cannot be updated incrementally.
+     * @param addr Address of the prefix (unused).
+     * @param prefix Length of the prefix (unused).
+     * @return Always false.
+     */
+    virtual bool withdraw(uint32_t *addr, int prefix);
+
+    /**
+     * Searches address inside the trie and tries to find the corresponding ASN.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual inline uint32_t longestPrefixMatch(uint32_t *addr) {
+        const TrieNode *nodes = &_pushed[0];
+        const TrieNode *currNode = &nodes[ROOT_NODE];
+        register uint32_t ip_seg = 0;
+        int bitLength = familyInfo->getAddrBitLength();
+        int i;
+
+        /* Internal node has both children, so the walk ends only in the leaf, the latest at the last bit */
+        for (i = 0; i < bitLength; i++) {
+            if (i % 32 == 0) {         // New address segment reached, load it into ip_seg
+                ip_seg = addr[i / 32];
+            }
+
+            uint32_t childNode = currNode->getChild(ip_seg >> 31); // MSB selects right (1) or left (0) child
+            if (childNode == ROOT_NODE) {  // Leaf reached
+                break;
+            }
+            currNode = &nodes[childNode];
+            ip_seg <<= 1;
+        }
+
+        LPM_STATS_WALK(bitLength, i, currNode->getValue());
+        return currNode->getValue();
+    }
+
+    /**
+     * Searches more addresses at once. Walks of the BATCH_WAYS addresses advance
+     * in lockstep, next node of every walk is prefetched and read one round later.
+     * @param addrs Addresses which should be searched, each has getAddrWords() words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    virtual inline void longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out) {
+        const TrieNode *nodes = &_pushed[0];
+        int bitLength = familyInfo->getAddrBitLength();
+        int words = getAddrWords();
+        uint32_t currNodes[BATCH_WAYS];
+        bool finished[BATCH_WAYS];
+
+        for (size_t base = 0; base < n; base += BATCH_WAYS) {
+            size_t ways = (n - base < BATCH_WAYS) ? n - base : BATCH_WAYS;
+            const uint32_t *addr = &addrs[base * words];
+            size_t active = ways;
+
+            for (size_t w = 0; w < ways; w++) {
+                currNodes[w] = ROOT_NODE;
+                finished[w] = false;
+            }
+
+            /* Every round reads prefetched node of each walk and prefetches its child */
+            for (int i = 0; active > 0; i++) {
+                for (size_t w = 0; w < ways; w++) {
+                    if (finished[w]) {
+                        continue;
+                    }
+
+                    // Leaf behind the last bit has no child for any bit, so the bit wraps to the first one
+                    const TrieNode *currNode = &nodes[currNodes[w]];
+                    uint32_t childNode = currNode->getChild(getBit(&addr[w * words], i & (bitLength - 1)));
+                    if (childNode == ROOT_NODE) {    // Leaf reached, walk is finished
+                        out[base + w] = currNode->getValue();
+                        LPM_STATS_WALK(bitLength, i, out[base + w]);
+                        finished[w] = true;
+                        active--;
+                    } else {
+                        currNodes[w] = childNode;
+                        __builtin_prefetch(&nodes[childNode]);
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Clears all trie/removes from the memory.
+     */
+    virtual void clear();
+
+    /**
+     * Fills statistics about the content and memory usage of the trie.
+     * @param stats Structure which will be filled, nodes and memory are of the pushed
+     *              trie, uncompressed nodes and memory are of the source bit trie.
+     */
+    virtual void getStats(LookupStats &stats) const;
+
+private:
+    vector<TrieNode> _pushed;           /**< Nodes of the pushed trie, root is the first one */
+    map<uint32_t, uint32_t> _leaves;    /**< Index of the shared leaf of each ASN */
+
+    /**
+     * Pushes the leaves of the subtrie of the bit trie.
+     * @param nodes Nodes of the bit trie.
+     * @param node Root of the subtrie.
+     * @param value ASN of the longest prefix covering the root, or NO_ASN.
+     * @return Index of the pushed node or leaf.
+     */
+    uint32_t pushNode(const TrieNode *nodes, uint32_t node, uint32_t value);
+
+    /**
+     * Returns shared leaf with the ASN, leaf is created when it does not exist.
+     * @param value ASN of the leaf, or NO_ASN.
+     * @return Index of the leaf.
+     */
+    uint32_t getLeaf(uint32_t value);
+
+    LeafPushedTrieBase(const LeafPushedTrieBase &);
+    LeafPushedTrieBase &operator=(const LeafPushedTrieBase &);
+};
+
+#endif // LEAFPUSHEDTRIEBASE_H
@@ -0,0 +1,299 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LengthSearchTable.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing table searching binary over prefix lengths.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LengthSearchTable.cpp
+ *
+ * @brief Implements table searching binary over prefix lengths.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <algorithm>
+
+#include "LengthSearchTable.h"
+
+const uint32_t LengthSearchTable::PREFIX;
+const uint32_t LengthSearchTable::MARKER;
+const size_t LengthSearchTable::MIN_CAPACITY;
+const size_t LengthSearchTable::BATCH_WAYS;
+
+/**
+ * Constructs empty table.
+ * @param familyInfo Informations about addresses which will this table accept.
+ */
+LengthSearchTable::LengthSearchTable(FamilyInfoBase *familyInfo)
+    : AddrLookupBase(familyInfo), _tables(familyInfo->getAddrBitLength() + 1), _defaultAsn(NO_ASN), _prefixCount(0)
+{
+}
+
+/**
+ * Destructor of the table.
+ */
+LengthSearchTable::~LengthSearchTable()
+{
+}
+
+/**
+ * Finds entry of the masked key or inserts empty one, table grows
+ * when it is filled up to half.
+ * @param key Masked key.
+ * @return Found or inserted entry, inserted entry has no flags.
+ */
+LengthEntry &LengthSearchTable::HashTable::lookup(const uint64_t *key) {
+    if ((size + 1) * 2 > entries.size()) {
+        rehash(entries.empty() ? MIN_CAPACITY : entries.size() * 2);
+    }
+
+    size_t index = slot(key);
+    for (; entries[index].flags != 0; index = (index + 1) & mask) {
+        if ((entries[index].key[0] == key[0]) && (entries[index].key[1] == key[1])) {
+            return entries[index];
+        }
+    }
+
+    entries[index].key[0] = key[0];
+    entries[index].key[1] = key[1];
+    size++;
+    return entries[index];
+}
+
+/**
+ * Moves used entries into new array of entries.
+ * @param capacity Number of the entries, power of 2.
+ */
+void LengthSearchTable::HashTable::rehash(size_t capacity) {
+    vector<LengthEntry> old;
+    old.swap(entries);
+
+    LengthEntry empty = {{0, 0}, NO_ASN, 0};
+    entries.assign(capacity, empty);
+    mask = capacity - 1;
+    shift = 64;
+    while (((size_t)1 << (64 - shift)) < capacity) {
+        shift--;
+    }
+
+    for (vector<LengthEntry>::iterator it = old.begin(); it != old.end(); ++it) {
+        if (it->flags != 0) {
+            size_t index = slot(it->key);
+            while (entries[index].flags != 0) {
+                index = (index + 1) & mask;
+            }
+            entries[index] = *it;
+        }
+    }
+}
+
+/**
+ * Inserts new ASN into table, markers are updated by build().
+ * @param addr Address which should be inserted.
+ * @param prefix Defines how many bits should be stored into table.
+ * @param asn Number of the autonomous system to be stored.
+ * @return True if no error occurs, false for duplicate or invalid prefix.
+ */
+bool LengthSearchTable::insertASN(uint32_t *addr, int prefix, uint32_t asn) {
+    if ((prefix < 0) || (prefix > familyInfo->getAddrBitLength()) || (asn == NO_ASN)) {
+        return false;
+    }
+
+    if (prefix == 0) {                            // Default route is not hashed
+        if (_defaultAsn != NO_ASN) {
+            return false;
+        }
+        _defaultAsn = asn;
+        _prefixCount++;
+        return true;
+    }
+
+    uint64_t key[2];
+    makeKey(addr, key);
+    maskKey(key, prefix, key);
+
+    HashTable &table = _tables[prefix];
+    if (table.size == 0) {                        // New populated length
+        _lengths.insert(lower_bound(_lengths.begin(), _lengths.end(), prefix), prefix);
+    }
+
+    LengthEntry &entry = table.lookup(key);
+    if (entry.flags & PREFIX) {                   // The first of the duplicates wins
+        return false;
+    }
+    entry.asn = asn;
+    entry.flags |= PREFIX;
+    _prefixCount++;
+
+    return true;
+}
+
+/**
+ * Computes markers of the inserted prefixes. Markers of the previous build
+ * are dropped first, new length could have changed the search order.
+ */
+void LengthSearchTable::build() {
+    int count = (int)_lengths.size();
+
+    /* Entries are moved in the order of their slots, so the capacity stays the
+       same, smaller table would pile them up into one long cluster. */
+    for (int i = 0; i < count; i++) {
+        HashTable &table = _tables[_lengths[i]];
+        table.size = 0;
+        for (vector<LengthEntry>::iterator it = table.entries.begin(); it != table.entries.end(); ++it) {
+            it->flags &= PREFIX;
+            if (it->flags != 0) {
+                table.size++;
+            }
+        }
+        table.rehash(table.entries.size());
+    }
+
+    /* Every prefix marks the lengths where the search towards it turns longer.
+       Only shorter tables are changed, so the entries of the current one stay valid. */
+    for (int i = 0; i < count; i++) {
+        const vector<LengthEntry> &entries = _tables[_lengths[i]].entries;
+
+        for (vector<LengthEntry>::const_iterator it = entries.begin(); it != entries.end(); ++it) {
+            if (!(it->flags & PREFIX)) {
+                continue;
+            }
+
+            int low = 0;
+            int high = count - 1;
+            while (low <= high) {
+                int middle = (low + high) >> 1;
+                if (middle == i) {
+                    break;
+                }
+
+                if (middle < i) {
+                    insertMarker(_lengths[middle], it->key, middle);
+                    low = middle + 1;
+                } else {
+                    high = middle - 1;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Inserts marker of the longer prefix, unless the entry already exists.
+ * New marker gets ASN of the longest prefix which matches it.
+ * @param length Length of the marker.
+ * @param key Key of the longer prefix.
+ * @param index Index of the length in the populated lengths.
+ */
+void LengthSearchTable::insertMarker(int length, const uint64_t *key, int index) {
+    uint64_t masked[2];
+    maskKey(key, length, masked);
+
+    LengthEntry &entry = _tables[length].lookup(masked);
+    if (entry.flags != 0) {                       // Prefix or marker is already there
+        entry.flags |= MARKER;
+        return;
+    }
+    entry.flags = MARKER;
+    entry.asn = _defaultAsn;
+
+    for (int i = index - 1; i >= 0; i--) {        // The longest shorter prefix
+        const LengthEntry *shorter = _tables[_lengths[i]].find(key, _lengths[i]);
+        if ((shorter != NULL) && (shorter->flags & PREFIX)) {
+            entry.asn = shorter->asn;
+            break;
+        }
+    }
+}
+
+/**
+ * Searches more addresses at once. Searches advance in lockstep, each round
+ * prefetches the probed entries of all searches before they are compared,
+ * so the cache misses of the hash tables overlap.
+ * @param addrs Addresses which should be searched, each has getAddrWords() words.
+ * @param n Number of the addresses.
+ * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+ */
+void LengthSearchTable::longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out) {
+    int words = getAddrWords();
+    uint64_t keys[BATCH_WAYS][2];
+    uint64_t masked[BATCH_WAYS][2];
+    size_t slots[BATCH_WAYS];
+    int lows[BATCH_WAYS];
+    int highs[BATCH_WAYS];
+
+    for (size_t base = 0; base < n; base += BATCH_WAYS) {
+        size_t ways = (n - base < BATCH_WAYS) ? n - base : BATCH_WAYS;
+
+        for (size_t w = 0; w < ways; w++) {
+            makeKey(&addrs[(base + w) * words], keys[w]);
+            out[base + w] = _defaultAsn;
+            lows[w] = 0;
+            highs[w] = (int)_lengths.size() - 1;
+        }
+
+        for (bool active = true; active;) {
+            /* Probed entries of all searches are prefetched first */
+            for (size_t w = 0; w < ways; w++) {
+                if (lows[w] <= highs[w]) {
+                    int length = _lengths[(lows[w] + highs[w]) >> 1];
+                    const HashTable &table = _tables[length];
+                    maskKey(keys[w], length, masked[w]);
+                    slots[w] = table.slot(masked[w]);
+                    __builtin_prefetch(&table.entries[slots[w]]);
+                }
+            }
+
+            active = false;
+            for (size_t w = 0; w < ways; w++) {
+                if (lows[w] > highs[w]) {
+                    continue;
+                }
+
+                int middle = (lows[w] + highs[w]) >> 1;
+                const LengthEntry *entry = _tables[_lengths[middle]].findAt(masked[w], slots[w]);
+                if (entry == NULL) {              // Nothing of this length, try shorter
+                    highs[w] = middle - 1;
+                } else {
+                    out[base + w] = entry->asn;
+                    // Nothing longer extends the prefix without marker
+                    lows[w] = (entry->flags & MARKER) ? middle + 1 : highs[w] + 1;
+                }
+                active = active || (lows[w] <= highs[w]);
+            }
+        }
+    }
+}
+
+/**
+ * Clears all table/removes from the memory.
+ */
+void LengthSearchTable::clear() {
+    for (size_t i = 0; i < _lengths.size(); i++) {
+        HashTable empty;
+        _tables[_lengths[i]] = empty;
+    }
+    _lengths.clear();
+    _defaultAsn = NO_ASN;
+    _prefixCount = 0;
+}
+
+/**
+ * Fills statistics about the content and memory usage of the table.
+ * @param stats Structure which will be filled, nodes are the entries including markers.
+ */
+void LengthSearchTable::getStats(LookupStats &stats) const {
+    stats.prefixes = _prefixCount;
+    stats.nodes = 0;
+    stats.bytes = 0;
+    for (size_t i = 0; i < _lengths.size(); i++) {
+        stats.nodes += _tables[_lengths[i]].size;
+        stats.bytes += _tables[_lengths[i]].entries.size() * sizeof(LengthEntry);
+    }
+    stats.uncompressedNodes = 0;
+    stats.uncompressedBytes = 0;
+}
@@ -0,0 +1,264 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LengthSearchTable.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines table searching binary over prefix lengths.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LengthSearchTable.h
+ *
+ * @brief Defines table searching binary over prefix lengths.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef LENGTHSEARCHTABLE_H
+#define LENGTHSEARCHTABLE_H
+
+#include <vector>
+
+#include "AddrLookupBase.h"
+
+using namespace std;
+
+/**
+ * Entry of the hash table of one prefix length.
+ */
+struct LengthEntry {
+    uint64_t key[2];            /**< Prefix masked to the length of the table, 0 for the empty entry */
+    uint32_t asn;               /**< ASN of the prefix, or ASN of the longest shorter prefix for marker */
+    uint32_t flags;             /**< PREFIX and MARKER flags, 0 for the empty entry */
+};
+
+/**
+ * Table which searches binary over the lengths of the stored prefixes
+ * (Waldvogel et al.), intended for long IPv6 addresses. Every populated
+ * length has its own open addressing hash table keyed by the masked address.
+ * Search starts at the middle length, hit continues with the longer half of
+ * the lengths, miss with the shorter half, so the lookup costs at most
+ * log2(lengths) + 1 hash probes instead of walking all bits.
+ *
+ * Prefix leaves marker at every shorter length where the search has to turn
+ * to the longer half to reach it. Marker keeps ASN of the longest prefix
+ * which matches it, so search misled by marker still knows the answer.
+ * Entry which is not marker stops the search, nothing longer extends it.
+ *
+ * Markers depend on all prefixes, they are computed by build() which has to
+ * be called after prefixes are inserted and before searching.
+ */
+class LengthSearchTable : public AddrLookupBase
+{
+public:
+    /**
+     * Constructs empty table.
+     * @param familyInfo Informations about addresses which will this table accept.
+     */
+    LengthSearchTable(FamilyInfoBase *familyInfo);
+
+    /**
+     * Destructor of the table.
+     */
+    virtual ~LengthSearchTable();
+
+    using AddrLookupBase::insertASN;
+    using AddrLookupBase::longestPrefixMatch;
+
+    /**
+     * Inserts new ASN into table, markers are updated by build().
+     * @param addr Address which should be inserted.
+     * @param prefix Defines how many bits should be stored into table.
+     * @param asn Number of the autonomous system to be stored.
+     * @return True if no error occurs, false for duplicate or invalid prefix.
+     */
+    virtual bool insertASN(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Computes markers of the inserted prefixes.
+     */
+    virtual void build();
+
+    /**
+     * Searches address inside the table and tries to find the corresponding ASN.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual inline uint32_t longestPrefixMatch(uint32_t *addr) {
+        uint64_t key[2];
+        uint32_t ret_value = _defaultAsn;
+        int low = 0;
+        int high = (int)_lengths.size() - 1;
+
+        makeKey(addr, key);
+        while (low <= high) {
+            int middle = (low + high) >> 1;
+            const LengthEntry *entry = _tables[_lengths[middle]].find(key, _lengths[middle]);
+
+            if (entry == NULL) {                 // Nothing of this length, try shorter
+                high = middle - 1;
+                continue;
+            }
+
+            ret_value = entry->asn;
+            if (!(entry->flags & MARKER)) {      // Nothing longer extends the prefix
+                break;
+            }
+            low = middle + 1;
+        }
+
+        return ret_value;
+    }
+
+    /**
+     * Searches more addresses at once. Searches advance in lockstep, each round
+     * prefetches the probed entries of all searches before they are compared,
+     * so the cache misses of the hash tables overlap.
+     * @param addrs Addresses which should be searched, each has getAddrWords() words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    virtual void longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out);
+
+    /**
+     * Clears all table/removes from the memory.
+     */
+    virtual void clear();
+
+    /**
+     * Fills statistics about the content and memory usage of the table.
+     * @param stats Structure which will be filled, nodes are the entries including markers.
+     */
+    virtual void getStats(LookupStats &stats) const;
+
+    const static uint32_t PREFIX = 1;         /**< Entry holds prefix */
+    const static uint32_t MARKER = 2;         /**< Entry is marker of longer prefixes */
+    const static size_t MIN_CAPACITY = 16;    /**< Initial number of entries of the hash table */
+    const static size_t BATCH_WAYS = 16;      /**< Number of the searches advancing in lockstep */
+
+private:
+    /**
+     * Open addressing hash table of the prefixes of one length.
+     */
+    struct HashTable {
+        vector<LengthEntry> entries;        /**< Entries, number is power of 2 */
+        size_t mask;                        /**< Number of the entries minus 1 */
+        int shift;                          /**< 64 minus number of the index bits */
+        size_t size;                        /**< Number of the used entries */
+
+        /**
+         * Constructs empty table without entries.
+         */
+        HashTable() : mask(0), shift(64), size(0) {}
+
+        /**
+         * Returns first entry probed for the key. Lower bits of the short
+         * prefixes are zero, so upper half is folded into them before the
+         * multiplication and the index is taken from the upper bits of the product.
+         * @param key Masked key.
+         * @return Index of the entry.
+         */
+        inline size_t slot(const uint64_t *key) const {
+            uint64_t hash = key[0] ^ (key[1] * 0x9E3779B97F4A7C15);
+            return ((hash ^ (hash >> 32)) * 0xBF58476D1CE4E5B9) >> shift;
+        }
+
+        /**
+         * Finds entry of the key starting at the slot.
+         * @param key Masked key.
+         * @param index Index of the first probed entry.
+         * @return Found entry or NULL.
+         */
+        inline const LengthEntry *findAt(const uint64_t *key, size_t index) const {
+            for (;; index = (index + 1) & mask) {
+                const LengthEntry &entry = entries[index];
+                if (entry.flags == 0) {
+                    return NULL;
+                }
+                if ((entry.key[0] == key[0]) && (entry.key[1] == key[1])) {
+                    return &entry;
+                }
+            }
+        }
+
+        /**
+         * Finds entry of the address.
+         * @param key Whole address as search key.
+         * @param length Length of the prefixes in the table.
+         * @return Found entry or NULL.
+         */
+        inline const LengthEntry *find(const uint64_t *key, int length) const {
+            uint64_t masked[2];
+            maskKey(key, length, masked);
+            return findAt(masked, slot(masked));
+        }
+
+        /**
+         * Finds entry of the masked key or inserts empty one, table grows
+         * when it is filled up to half.
+         * @param key Masked key.
+         * @return Found or inserted entry, inserted entry has no flags.
+         */
+        LengthEntry &lookup(const uint64_t *key);
+
+        /**
+         * Moves used entries into new array of entries.
+         * @param capacity Number of the entries, power of 2.
+         */
+        void rehash(size_t capacity);
+    };
+
+    vector<HashTable> _tables;  /**< Hash tables indexed by the prefix length */
+    vector<int> _lengths;       /**< Populated lengths in ascending order, without 0 */
+    uint32_t _defaultAsn;       /**< ASN of the prefix 0 */
+    size_t _prefixCount;        /**< Number of the stored prefixes */
+
+    /**
+     * Converts address into search key of two 64 bit words.
+     * @param addr Address as host ordered 32 bit words.
+     * @param key Space for the key.
+     */
+    inline void makeKey(const uint32_t *addr, uint64_t *key) const {
+        if (familyInfo->getAddrBitLength() == 32) {
+            key[0] = (uint64_t)addr[0] << 32;
+            key[1] = 0;
+        } else {
+            key[0] = ((uint64_t)addr[0] << 32) | addr[1];
+            key[1] = ((uint64_t)addr[2] << 32) | addr[3];
+        }
+    }
+
+    /**
+     * Clears bits of the key behind the prefix length.
+     * @param key Search key.
+     * @param length Length of the prefix.
+     * @param masked Space for the masked key.
+     */
+    static inline void maskKey(const uint64_t *key, int length, uint64_t *masked) {
+        masked[0] = key[0] & highBits((length > 64) ? 64 : length);
+        masked[1] = key[1] & highBits((length > 64) ? length - 64 : 0);
+    }
+
+    /**
+     * Returns 64 bit word with upper bits set.
+     * @param count Number of the set bits (0-64).
+     * @return Word with count upper bits set.
+     */
+    static inline uint64_t highBits(int count) {
+        return (count == 0) ? 0 : ~(uint64_t)0 << (64 - count);
+    }
+
+    /**
+     * Inserts marker of the longer prefix, unless the entry already exists.
+     * @param length Length of the marker.
+     * @param key Key of the longer prefix.
+     * @param index Index of the length in the populated lengths.
+     */
+    void insertMarker(int length, const uint64_t *key, int index);
+
+    LengthSearchTable(const LengthSearchTable &);
+    LengthSearchTable &operator=(const LengthSearchTable &);
+};
+
+#endif // LENGTHSEARCHTABLE_H
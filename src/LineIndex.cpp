@@ -0,0 +1,211 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LineIndex.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing index of the lines of the block.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LineIndex.cpp
+ *
+ * @brief Implements index of the lines of the block.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "LineIndex.h"
+
+const uint32_t LineIndex::LINE_IPV6;
+
+/**
+ * Size of the part of the block which is described by one bitmap.
+ */
+const static size_t PART_SIZE = 64;
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Compares part of the block by AVX2 instructions.
+ */
+struct Avx2Masks {
+    /**
+     * Finds new lines and colons of the part.
+     * @param part Part of the block, it has PART_SIZE bytes.
+     * @param newlines Set to the bitmap of the new lines.
+     * @param colons Set to the bitmap of the colons.
+     */
+    static inline __attribute__((target("avx2"))) void find(const char *part, uint64_t &newlines, uint64_t &colons) {
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(part));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(part + 32));
+        __m256i newline = _mm256_set1_epi8('\n');
+        __m256i colon = _mm256_set1_epi8(':');
+
+        newlines = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, newline))
+                   | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, newline)) << 32;
+        colons = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, colon))
+                 | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, colon)) << 32;
+    }
+};
+
+/**
+ * Compares part of the block by SSE2 instructions.
+ */
+struct Sse2Masks {
+    /**
+     * Finds new lines and colons of the part.
+     * @param part Part of the block, it has PART_SIZE bytes.
+     * @param newlines Set to the bitmap of the new lines.
+     * @param colons Set to the bitmap of the colons.
+     */
+    static inline __attribute__((target("sse2"))) void find(const char *part, uint64_t &newlines, uint64_t &colons) {
+        __m128i newline = _mm_set1_epi8('\n');
+        __m128i colon = _mm_set1_epi8(':');
+
+        newlines = 0;
+        colons = 0;
+        for (int i = 0; i < 4; i++) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(part + 16 * i));
+            newlines |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newline)) << (16 * i);
+            colons |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, colon)) << (16 * i);
+        }
+    }
+};
+#endif
+
+/**
+ * Compares part of the block byte by byte.
+ */
+struct ScalarMasks {
+    /**
+     * Finds new lines and colons of the part.
+     * @param part Part of the block, it has PART_SIZE bytes.
+     * @param newlines Set to the bitmap of the new lines.
+     * @param colons Set to the bitmap of the colons.
+     */
+    static inline void find(const char *part, uint64_t &newlines, uint64_t &colons) {
+        newlines = 0;
+        colons = 0;
+        for (size_t i = 0; i < PART_SIZE; i++) {
+            newlines |= (uint64_t)(part[i] == '\n') << i;
+            colons |= (uint64_t)(part[i] == ':') << i;
+        }
+    }
+};
+
+/**
+ * Indexes lines of the block part by part. Colon of the line which started
+ * in some of the previous parts is remembered until the line ends.
+ * @param block Block of the lines.
+ * @param length Length of the block in bytes.
+ * @param lines Array where the ends of the lines are stored.
+ * @return Number of the complete lines.
+ */
+template<class Masks>
+static inline size_t indexLines(const char *block, size_t length, uint32_t *lines) {
+    size_t count = 0;
+    bool colonBefore = false;   // Current line has colon in the previous parts
+
+    for (size_t base = 0; base < length; base += PART_SIZE) {
+        uint64_t newlines, colons;
+
+        if (length - base >= PART_SIZE) {
+            Masks::find(&block[base], newlines, colons);
+        } else {                // Last part is padded, so it is not read behind the block
+            char part[PART_SIZE];
+            memset(part, 0, sizeof(part));
+            memcpy(part, &block[base], length - base);
+            Masks::find(part, newlines, colons);
+        }
+
+        while (newlines != 0) {
+            int bit = __builtin_ctzll(newlines);
+            uint64_t before = ((uint64_t)1 << bit) - 1;
+
+            lines[count++] = (uint32_t)(base + bit) | ((colonBefore || (colons & before)) ? LineIndex::LINE_IPV6 : 0);
+            colons &= ~before;
+            colonBefore = false;
+            newlines &= newlines - 1;
+        }
+        colonBefore = colonBefore || (colons != 0);
+    }
+
+    return count;
+}
+
+/**
+ * Constructs empty index, instruction set is detected on x86.
+ */
+LineIndex::LineIndex() : _hasAvx2(false), _hasSse2(false)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    _hasAvx2 = __builtin_cpu_supports("avx2");
+    _hasSse2 = __builtin_cpu_supports("sse2");
+#endif
+}
+
+/**
+ * Indexes all complete lines of the block, incomplete last line is not indexed.
+ * @param block Block of the lines.
+ * @param length Length of the block in bytes, it must be less than 2 GiB.
+ * @return Number of the complete lines.
+ */
+size_t LineIndex::build(const char *block, size_t length) {
+    if (_lines.size() < length) {       // Every byte could end the line
+        _lines.resize(length);
+    }
+
+    if (length == 0) {
+        return 0;
+    }
+#if defined(__x86_64__) || defined(__i386__)
+    if (_hasAvx2) {
+        return buildAvx2(block, length, &_lines[0]);
+    } else if (_hasSse2) {
+        return buildSse2(block, length, &_lines[0]);
+    }
+#endif
+    return buildScalar(block, length, &_lines[0]);
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Indexes lines, bitmaps are compared by AVX2 instructions.
+ * @param block Block of the lines.
+ * @param length Length of the block in bytes.
+ * @param lines Array where the ends of the lines are stored.
+ * @return Number of the complete lines.
+ */
+size_t LineIndex::buildAvx2(const char *block, size_t length, uint32_t *lines) {
+    return indexLines<Avx2Masks>(block, length, lines);
+}
+
+/**
+ * Indexes lines, bitmaps are compared by SSE2 instructions.
+ * @param block Block of the lines.
+ * @param length Length of the block in bytes.
+ * @param lines Array where the ends of the lines are stored.
+ * @return Number of the complete lines.
+ */
+size_t LineIndex::buildSse2(const char *block, size_t length, uint32_t *lines) {
+    return indexLines<Sse2Masks>(block, length, lines);
+}
+#endif
+
+/**
+ * Indexes lines, bitmaps are compared byte by byte.
+ * @param block Block of the lines.
+ * @param length Length of the block in bytes.
+ * @param lines Array where the ends of the lines are stored.
+ * @return Number of the complete lines.
+ */
+size_t LineIndex::buildScalar(const char *block, size_t length, uint32_t *lines) {
+    return indexLines<ScalarMasks>(block, length, lines);
+}
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LineIndex.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines index of the lines of the block.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LineIndex.h
+ *
+ * @brief Defines index of the lines of the block.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include <stdint.h>
+
+#include <vector>
+
+using namespace std;
+
+/**
+ * Index of the complete lines of the block. Block is scanned by 64 bytes,
+ * every part yields bitmap of the new lines and bitmap of the colons, bits
+ * of the new lines are then turned into the ends of the lines and line with
+ * colon is marked as IPv6. Bitmaps are compared by AVX2 or SSE2 instructions
+ * if the processor has them, otherwise (and on other architectures than x86)
+ * byte by byte.
+ */
+class LineIndex
+{
+public:
+    /**
+     * Constructs empty index, instruction set is detected.
+     */
+    LineIndex();
+
+    /**
+     * Indexes all complete lines of the block.
+     * @param block Block of the lines.
+     * @param length Length of the block in bytes, it must be less than 2 GiB.
+     * @return Number of the complete lines.
+     */
+    size_t build(const char *block, size_t length);
+
+    /**
+     * Returns end of the line.
+     * @param line Index of the line.
+     * @return Offset of the new line character which ends the line.
+     */
+    inline size_t getEnd(size_t line) const {
+        return _lines[line] & ~LINE_IPV6;
+    }
+
+    /**
+     * Tells whether the line holds colon, so it is IPv6 address.
+     * @param line Index of the line.
+     * @return True if the line holds colon, else false.
+     */
+    inline bool isIPv6(size_t line) const {
+        return (_lines[line] & LINE_IPV6) != 0;
+    }
+
+    const static uint32_t LINE_IPV6 = 0x80000000;  /**< Flag of the line end which marks line with colon */
+
+private:
+    vector<uint32_t> _lines;    /**< Ends of the lines with the IPv6 flag */
+    bool _hasAvx2;              /**< Processor has AVX2 instructions */
+    bool _hasSse2;              /**< Processor has SSE2 instructions */
+
+#if defined(__x86_64__) || defined(__i386__)
+    /**
+     * Indexes lines, bitmaps are compared by AVX2 instructions.
+     * @param block Block of the lines.
+     * @param length Length of the block in bytes.
+     * @param lines Array where the ends of the lines are stored.
+     * @return Number of the complete lines.
+     */
+    static size_t buildAvx2(const char *block, size_t length, uint32_t *lines) __attribute__((target("avx2"), flatten));
+
+    /**
+     * Indexes lines, bitmaps are compared by SSE2 instructions.
+     * @param block Block of the lines.
+     * @param length Length of the block in bytes.
+     * @param lines Array where the ends of the lines are stored.
+     * @return Number of the complete lines.
+     */
+    static size_t buildSse2(const char *block, size_t length, uint32_t *lines) __attribute__((target("sse2"), flatten));
+#endif
+
+    /**
+     * Indexes lines, bitmaps are compared byte by byte.
+     * @param block Block of the lines.
+     * @param length Length of the block in bytes.
+     * @param lines Array where the ends of the lines are stored.
+     * @return Number of the complete lines.
+     */
+    static size_t buildScalar(const char *block, size_t length, uint32_t *lines);
+
+    LineIndex(const LineIndex &);
+    LineIndex &operator=(const LineIndex &);
+};
+
+#endif // LINEINDEX_H
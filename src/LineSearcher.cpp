@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LineSearcher.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing searcher of the addresses given by lines.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LineSearcher.cpp
+ *
+ * @brief Implements searcher of the addresses given by lines.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include <arpa/inet.h>
+
+#include "LineSearcher.h"
+#include "RuntimeStats.h"
+
+const size_t LineSearcher::BATCH_SIZE;
+const size_t LineSearcher::ASN_LINE_MAXLEN;
+
+/**
+ * Constructs searcher, tables are set by setTables().
+ * @param updates Apply update lines to the tables, tables must not be searched by other threads.
+ * @param cacheEntries Number of the addresses cached for each family, 0 disables the cache.
+ * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+ */
+LineSearcher::LineSearcher(bool updates, size_t cacheEntries, bool binaryOutput)
+    : _lines(0), _updates(updates), _binaryOutput(binaryOutput), _ipv4Cache(NULL), _ipv6Cache(NULL), _version(0)
+{
+    for (int family = 0; family < BATCH_FAMILIES; family++) {
+        _tries[family] = NULL;
+    }
+    for (int family = 0; family <= BATCH_FAMILIES; family++) {
+        _counts[family] = 0;
+    }
+
+    if (cacheEntries != 0) {
+        _ipv4Cache = new LookupCache<1>(cacheEntries);
+        _ipv6Cache = new LookupCache<4>(cacheEntries);
+    }
+}
+
+/**
+ * Destructor of the searcher.
+ */
+LineSearcher::~LineSearcher()
+{
+    delete _ipv4Cache;
+    delete _ipv6Cache;
+}
+
+/**
+ * Searches all complete lines of the block, incomplete last line is left.
+ * Results of the last lines could stay in batch until finish() is called.
+ * Lines and their families are found by one pass of the index first, so
+ * address is parsed by the parser of its family right from the line and only
+ * line which is not a plain address is terminated and parsed again.
+ * @param block NUL terminated block of lines, new line characters could be replaced by '\0'.
+ * @param length Length of the block in bytes.
+ * @param rest Set to the beginning of the incomplete last line.
+ * @param output Buffer where should be results printed.
+ * @return True if no error occurs, false if output has failed.
+ */
+bool LineSearcher::searchBlock(char *block, size_t length, char *&rest, OutputBuffer &output) {
+    size_t lines = _index.build(block, length);
+    size_t start = 0;
+
+    // Parsing loop
+    for (size_t line = 0; line < lines; line++) {
+        char *lineChars = &block[start];
+        size_t end = _index.getEnd(line);
+        int family = _index.isIPv6(line) ? BATCH_IPV6 : BATCH_IPV4;
+        start = end + 1;
+
+        /* Address is parsed right from the line, line is terminated only when it is not a plain address */
+        size_t parsed = (family == BATCH_IPV4)
+                        ? IPv4AddrFamily::parse(lineChars, &_addrs[BATCH_IPV4][_counts[BATCH_IPV4]])
+                        : IPv6AddrFamily::parse(lineChars, &_addrs[BATCH_IPV6][_counts[BATCH_IPV6] * 4]);
+        if ((parsed != 0) && (lineChars + parsed == &block[end])) {
+            addParsed(family);
+        } else {
+            block[end] = '\0';     // Remove new line character on the address string
+
+            if (_updates && ((*lineChars == '+') || (*lineChars == '-'))) {
+                // Lines before the update are searched without it
+                if ((_lines != 0) && !searchBatch(output)) {
+                    return false;
+                }
+                applyUpdate(*_tries[family], lineChars);
+                clearCache();
+                continue;
+            }
+            addLine(family, lineChars);
+        }
+
+        if ((_lines == BATCH_SIZE) && !searchBatch(output)) {
+            return false;
+        }
+    }
+
+    rest = &block[start];
+    return true;
+}
+
+/**
+ * Applies update line "+prefix asn" or "-prefix" to the table, malformed lines are skipped.
+ * Address has to be valid address of the family of the table which ends exactly
+ * by '/', prefix length has to be in range of the family.
+ * @param trie Table of the address family of the line.
+ * @param lineChars NUL terminated update line, it is modified.
+ * @return True if the line has been applied, false if it is malformed or the table refused it.
+ */
+bool LineSearcher::applyUpdate(AddrLookupBase &trie, char *lineChars) {
+    uint32_t addr[4] = {0, 0, 0, 0};
+
+    char *prefixChars = strchr(lineChars + 1, '/');
+    if (prefixChars == NULL) {
+        return false;
+    }
+
+    size_t parsed = (trie.getAddrWords() == 1)
+                    ? IPv4AddrFamily::parse(lineChars + 1, addr)
+                    : IPv6AddrFamily::parse(lineChars + 1, addr);
+    if ((parsed == 0) || (lineChars + 1 + parsed != prefixChars)) {
+        return false;
+    }
+    prefixChars++;
+
+    char *asnChars;
+    long prefix = strtol(prefixChars, &asnChars, 10);
+    if ((asnChars == prefixChars) || (prefix < 0) || (prefix > trie.getAddrWords() * 32)) {
+        return false;
+    }
+
+    if (*lineChars == '+') {
+        char *asnEnd;
+        errno = 0;
+        unsigned long asn = strtoul(asnChars, &asnEnd, 10);
+        if ((asnEnd == asnChars) || (errno == ERANGE) || (asn > 0xFFFFFFFFUL)) {
+            return false;
+        }
+        return trie.update(addr, (int)prefix, asn);
+    }
+    return trie.withdraw(addr, (int)prefix);
+}
+
+/**
+ * Searches all lines of the batch and prints found ASNs in input order.
+ * Batch is emptied afterwards. Packed ASN fits into the space of the line.
+ * @param output Buffer where should be results printed.
+ * @return True if no error occurs, false if output has failed.
+ */
+bool LineSearcher::searchBatch(OutputBuffer &output) {
+    size_t next[BATCH_FAMILIES + 1];
+
+    if (!output.reserve(_lines * ASN_LINE_MAXLEN)) {
+        return false;
+    }
+
+    LPM_STATS_START(start);
+    for (int family = 0; family < BATCH_FAMILIES; family++) {
+        if (_counts[family] != 0) {
+            _tries[family]->longestPrefixMatchBatch(_addrs[family], _counts[family], _asns[family]);
+        }
+        next[family] = 0;
+    }
+    next[BATCH_CACHED] = 0;
+    LPM_STATS_PHASE(PHASE_LOOKUP, start);
+
+    if (_ipv4Cache != NULL) {      // Searched addresses are cached for the next lines
+        for (size_t i = 0; i < _counts[BATCH_IPV4]; i++) {
+            _ipv4Cache->insert(&_addrs[BATCH_IPV4][i], _asns[BATCH_IPV4][i]);
+        }
+        for (size_t i = 0; i < _counts[BATCH_IPV6]; i++) {
+            _ipv6Cache->insert(&_addrs[BATCH_IPV6][i * 4], _asns[BATCH_IPV6][i]);
+        }
+    }
+
+    LPM_STATS_RESTART(start);
+    char *wbuffChar = output.getPos();
+    for (size_t line = 0; line < _lines; line++) {
+        int family = _families[line];
+        uint32_t matched = _asns[family][next[family]++];
+        LPM_STATS_ADD(matchedLines, matched != AddrLookupBase::NO_ASN);
+
+        if (_binaryOutput) {   // Packed ASN, NO_ASN is 0 as well
+            uint32_t packed = htonl(matched);
+            memcpy(wbuffChar, &packed, sizeof(packed));
+            wbuffChar += sizeof(packed);
+            continue;
+        }
+
+        if (matched == AddrLookupBase::NO_ASN) { // No match found, print -
+            *wbuffChar++ = '-';
+        } else {               // Match found, print corresponding ASN into write buffer
+            wbuffChar = formatASN(matched, wbuffChar);
+        }
+        *wbuffChar++ = '\n';
+    }
+    output.setPos(wbuffChar);
+    LPM_STATS_ADD(lines, _lines);
+    LPM_STATS_PHASE(PHASE_FORMAT, start);
+
+    for (int family = 0; family <= BATCH_FAMILIES; family++) {
+        _counts[family] = 0;
+    }
+    _lines = 0;
+
+    return true;
+}
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LineSearcher.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines searcher of the addresses given by lines.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LineSearcher.h
+ *
+ * @brief Defines searcher of the addresses given by lines.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef LINESEARCHER_H
+#define LINESEARCHER_H
+
+#include <stdint.h>
+
+#include "AddrLookupBase.h"
+#include "LineIndex.h"
+#include "LookupCache.h"
+#include "OutputBuffer.h"
+
+/**
+ * Searcher of the addresses which are given by lines of the text. Lines of
+ * the block and their families are indexed at once, addresses are then parsed
+ * right from the lines and collected into batch, addresses of each family are searched by single
+ * batch call and found ASNs are printed in input order. Searcher only reads
+ * the tables, so every thread can have its own searcher over the same tables.
+ * Tables can be replaced between blocks, lines left in batch are then searched
+ * in the new tables. Searcher with enabled updates applies lines "+prefix asn"
+ * and "-prefix" to the tables instead of searching them, lines before the update
+ * are searched in the tables without it. Searcher with cache answers repeated
+ * addresses from its own cache, cache is cleared when version of the tables changes.
+ * Searcher with binary output prints ASNs as packed 32 bit numbers in network
+ * order instead of lines, 0 means no match.
+ */
+class LineSearcher
+{
+public:
+    /**
+     * Constructs searcher, tables are set by setTables().
+     * @param updates Apply update lines to the tables, tables must not be searched by other threads.
+     * @param cacheEntries Number of the addresses cached for each family, 0 disables the cache.
+     * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+     */
+    LineSearcher(bool updates = false, size_t cacheEntries = 0, bool binaryOutput = false);
+
+    /**
+     * Destructor of the searcher.
+     */
+    ~LineSearcher();
+
+    /**
+     * Sets tables which are used by the next searching.
+     * @param ipv4Trie Searching trie for IPv4 addresses.
+     * @param ipv6Trie Searching trie for IPv6 addresses.
+     * @param version Version of the tables, cached results of other version are dropped.
+     */
+    inline void setTables(AddrLookupBase &ipv4Trie, AddrLookupBase &ipv6Trie, unsigned long version = 0) {
+        _tries[BATCH_IPV4] = &ipv4Trie;
+        _tries[BATCH_IPV6] = &ipv6Trie;
+
+        if (version != _version) {
+            clearCache();
+            _version = version;
+        }
+    }
+
+    /**
+     * Searches all complete lines of the block, incomplete last line is left.
+     * Results of the last lines could stay in batch until finish() is called.
+     * @param block NUL terminated block of lines, new line characters could be replaced by '\0'.
+     * @param length Length of the block in bytes.
+     * @param rest Set to the beginning of the incomplete last line.
+     * @param output Buffer where should be results printed.
+     * @return True if no error occurs, false if output has failed.
+     */
+    bool searchBlock(char *block, size_t length, char *&rest, OutputBuffer &output);
+
+    /**
+     * Searches lines which are left in the batch.
+     * @param output Buffer where should be results printed.
+     * @return True if no error occurs, false if output has failed.
+     */
+    inline bool finish(OutputBuffer &output) {
+        return (_lines == 0) || searchBatch(output);
+    }
+
+    /**
+     * Applies update line "+prefix asn" or "-prefix" to the table, malformed lines are skipped.
+     * @param trie Table of the address family of the line.
+     * @param lineChars NUL terminated update line, it is modified.
+     * @return True if the line has been applied, false if it is malformed or the table refused it.
+     */
+    static bool applyUpdate(AddrLookupBase &trie, char *lineChars);
+
+    /**
+     * Returns number of the addresses answered from the cache.
+     * @return Number of the cache hits.
+     */
+    inline size_t getCacheHits() const {
+        return (_ipv4Cache == NULL) ? 0 : _ipv4Cache->getHits() + _ipv6Cache->getHits();
+    }
+
+    /**
+     * Returns number of the addresses which have been searched in the tables despite the cache.
+     * @return Number of the cache misses.
+     */
+    inline size_t getCacheMisses() const {
+        return (_ipv4Cache == NULL) ? 0 : _ipv4Cache->getMisses() + _ipv6Cache->getMisses();
+    }
+
+    /**
+     * Prints number of the autonomous system into buffer.
+     * @param asn Number of the autonomous system.
+     * @param buffer Buffer where should be number printed.
+     * @return Position behind the printed number.
+     */
+    static inline char *formatASN(uint32_t asn, char *buffer) {
+        char digits[10];   // 32 bit number has at most 10 digits
+        int count = 0;
+
+        do {
+            digits[count++] = '0' + asn % 10;
+            asn /= 10;
+        } while (asn != 0);
+
+        while (count > 0) {
+            *buffer++ = digits[--count];
+        }
+
+        return buffer;
+    }
+
+    const static size_t BATCH_SIZE = 256;     /**< Number of the lines which are searched at once */
+    const static size_t ASN_LINE_MAXLEN = 11; /**< Maximal length of the output line (32 bit number and new line) */
+
+private:
+    /**
+     * Indices of the address families inside the batch.
+     */
+    enum batchFamilies {
+        BATCH_IPV4 = 0,     /**< IPv4 addresses */
+        BATCH_IPV6 = 1,     /**< IPv6 addresses */
+        BATCH_FAMILIES = 2, /**< Number of the families */
+        BATCH_CACHED = 2    /**< Addresses answered from the cache, they are not searched */
+               };
+
+    AddrLookupBase *_tries[BATCH_FAMILIES];          /**< Searching tries indexed by the batch family */
+    uint32_t _addrs[BATCH_FAMILIES][BATCH_SIZE * 4]; /**< Converted addresses, IPv6 needs 4 words */
+    uint32_t _asns[BATCH_FAMILIES + 1][BATCH_SIZE];  /**< Found ASNs of the addresses, cached ones last */
+    size_t _counts[BATCH_FAMILIES + 1];              /**< Number of the addresses of each family and cached ones */
+    uint8_t _families[BATCH_SIZE];                   /**< Family of each line in input order */
+    size_t _lines;                                   /**< Number of the lines in batch */
+    LineIndex _index;                                /**< Ends and families of the lines of the current block */
+    bool _updates;                                   /**< Update lines are applied to the tables */
+    bool _binaryOutput;                              /**< ASNs are printed as packed 32 bit numbers */
+    LookupCache<1> *_ipv4Cache;                      /**< Cache of the IPv4 results, or NULL */
+    LookupCache<4> *_ipv6Cache;                      /**< Cache of the IPv6 results, or NULL */
+    unsigned long _version;                          /**< Version of the tables the cached results belong to */
+
+    /**
+     * Converts address of the line and adds it into batch.
+     * @param family Batch family of the address.
+     * @param lineChars Address in string representation.
+     */
+    inline void addLine(int family, char *lineChars) {
+        AddrLookupBase *trie = _tries[family];
+
+        trie->parseAddr(lineChars, &_addrs[family][_counts[family] * trie->getAddrWords()]);
+        addParsed(family);
+    }
+
+    /**
+     * Adds address which has been already parsed into batch.
+     * Cached address is answered at once and it is not searched.
+     * @param family Batch family of the address.
+     */
+    inline void addParsed(int family) {
+        if (_ipv4Cache != NULL) {
+            uint32_t *addr = &_addrs[family][_counts[family] * _tries[family]->getAddrWords()];
+            uint32_t *asn = &_asns[BATCH_CACHED][_counts[BATCH_CACHED]];
+
+            if ((family == BATCH_IPV4) ? _ipv4Cache->find(addr, *asn) : _ipv6Cache->find(addr, *asn)) {
+                _counts[BATCH_CACHED]++;
+                _families[_lines++] = BATCH_CACHED;
+                return;
+            }
+        }
+
+        _counts[family]++;
+        _families[_lines++] = family;
+    }
+
+    /**
+     * Removes all cached results.
+     */
+    inline void clearCache() {
+        if (_ipv4Cache != NULL) {
+            _ipv4Cache->clear();
+            _ipv6Cache->clear();
+        }
+    }
+
+    /**
+     * Searches all lines of the batch and prints found ASNs in input order.
+     * Batch is emptied afterwards.
+     * @param output Buffer where should be results printed.
+     * @return True if no error occurs, false if output has failed.
+     */
+    bool searchBatch(OutputBuffer &output);
+
+    LineSearcher(const LineSearcher &);
+    LineSearcher &operator=(const LineSearcher &);
+};
+
+#endif // LINESEARCHER_H
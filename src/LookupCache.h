@@ -0,0 +1,189 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LookupCache.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines cache of the lookup results.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LookupCache.h
+ *
+ * @brief Defines cache of the lookup results.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef LOOKUPCACHE_H
+#define LOOKUPCACHE_H
+
+#include <stdint.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+/**
+ * Set associative cache which maps searched addresses to the found ASNs,
+ * so addresses repeated in the input are not searched in the tables again.
+ * Every set fills exactly one cache line and the sets are aligned to it,
+ * so a lookup reads one line. Full set replaces its ways in round robin.
+ * Cache is not shared, every searching thread has its own one.
+ */
+template<int WORDS>
+class LookupCache
+{
+public:
+    const static size_t LINE_SIZE = 64;   /**< Size of the cache line */
+    const static int WAYS = (LINE_SIZE - sizeof(uint32_t)) / ((WORDS + 1) * sizeof(uint32_t)); /**< Addresses in one set */
+
+    /**
+     * Constructs empty cache.
+     * @param entries Requested number of the cached addresses, rounded up to the power of 2 sets.
+     */
+    LookupCache(size_t entries) : _hits(0), _misses(0) {
+        size_t count = 1;
+        while (count * WAYS < entries) {
+            count <<= 1;
+        }
+        _mask = count - 1;
+
+        void *memory;
+        if (posix_memalign(&memory, LINE_SIZE, count * sizeof(CacheSet)) != 0) {
+            throw std::bad_alloc();
+        }
+        _sets = static_cast<CacheSet *>(memory);
+        clear();
+    }
+
+    /**
+     * Destructor of the cache.
+     */
+    ~LookupCache() {
+        free(_sets);
+    }
+
+    /**
+     * Finds cached ASN of the address.
+     * @param addr Address as host ordered 32 bit words.
+     * @param asn Set to the cached ASN (NO_ASN included) if the address is cached.
+     * @return True if the address is cached, else false.
+     */
+    inline bool find(const uint32_t *addr, uint32_t &asn) {
+        const CacheSet &set = _sets[index(addr)];
+
+        for (int way = 0; way < WAYS; way++) {
+            if (((set.valid >> way) & 1) && equals(set.keys[way], addr)) {
+                asn = set.asns[way];
+                _hits++;
+                return true;
+            }
+        }
+
+        _misses++;
+        return false;
+    }
+
+    /**
+     * Stores ASN of the address, cached address is overwritten.
+     * @param addr Address as host ordered 32 bit words.
+     * @param asn Found ASN of the address.
+     */
+    inline void insert(const uint32_t *addr, uint32_t asn) {
+        CacheSet &set = _sets[index(addr)];
+        int way;
+
+        for (way = 0; way < WAYS; way++) {
+            if (((set.valid >> way) & 1) && equals(set.keys[way], addr)) {
+                break;
+            }
+        }
+
+        if (way == WAYS) {            // Address is not cached, the oldest way is replaced
+            way = set.next;
+            set.next = (set.next + 1) % WAYS;
+            set.valid |= 1 << way;
+            memcpy(set.keys[way], addr, sizeof(set.keys[way]));
+        }
+        set.asns[way] = asn;
+    }
+
+    /**
+     * Removes all cached addresses, counters are kept.
+     */
+    void clear() {
+        memset(_sets, 0, (_mask + 1) * sizeof(CacheSet));
+    }
+
+    /**
+     * Returns number of the addresses which have been found in the cache.
+     * @return Number of the hits.
+     */
+    inline size_t getHits() const {
+        return _hits;
+    }
+
+    /**
+     * Returns number of the addresses which have not been found in the cache.
+     * @return Number of the misses.
+     */
+    inline size_t getMisses() const {
+        return _misses;
+    }
+
+private:
+    /**
+     * Set of the cached addresses, it fills one cache line.
+     */
+    struct CacheSet {
+        uint32_t keys[WAYS][WORDS];     /**< Cached addresses */
+        uint32_t asns[WAYS];            /**< ASNs of the cached addresses */
+        uint16_t valid;                 /**< Bit i is set if the i-th way holds address */
+        uint16_t next;                  /**< Way which is replaced next */
+    } __attribute__((aligned(LINE_SIZE)));
+
+    CacheSet *_sets;            /**< Sets of the cache, number is power of 2 */
+    size_t _mask;               /**< Number of the sets minus 1 */
+    size_t _hits;               /**< Number of the hits */
+    size_t _misses;             /**< Number of the misses */
+
+    /**
+     * Returns set of the address.
+     * @param addr Address as host ordered 32 bit words.
+     * @return Index of the set.
+     */
+    inline size_t index(const uint32_t *addr) const {
+        uint64_t hash = 0;
+        for (int i = 0; i < WORDS; i++) {
+            hash = (hash ^ addr[i]) * 0x9E3779B97F4A7C15;
+        }
+        return (size_t)(hash >> 32) & _mask;
+    }
+
+    /**
+     * Compares cached address with the searched one.
+     * @param key Cached address.
+     * @param addr Searched address.
+     * @return True if the addresses are equal, else false.
+     */
+    static inline bool equals(const uint32_t *key, const uint32_t *addr) {
+        for (int i = 0; i < WORDS; i++) {
+            if (key[i] != addr[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    LookupCache(const LookupCache &);
+    LookupCache &operator=(const LookupCache &);
+};
+
+template<int WORDS>
+const size_t LookupCache<WORDS>::LINE_SIZE;
+
+template<int WORDS>
+const int LookupCache<WORDS>::WAYS;
+
+#endif // LOOKUPCACHE_H
@@ -0,0 +1,481 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LookupServer.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing server answering lookups over sockets.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LookupServer.cpp
+ *
+ * @brief Implements server answering lookups over sockets.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "LookupServer.h"
+
+const size_t LookupServer::READ_SIZE;
+const size_t LookupServer::OUTPUT_SIZE;
+const size_t LookupServer::BINARY_BATCH;
+const uint32_t LookupServer::MAX_FRAME;
+const size_t LookupServer::MAX_PENDING;
+const int LookupServer::MAX_EVENTS;
+const int LookupServer::BACKLOG;
+
+/**
+ * Size of the binary frame header.
+ */
+const static size_t HEADER_SIZE = 4;
+
+/**
+ * Default host of the TCP socket.
+ */
+const static char *DEFAULT_HOST = "127.0.0.1";
+
+/**
+ * Switches descriptor into non-blocking mode.
+ * @param fd Descriptor which should be switched.
+ * @return True if no error occurs, else false.
+ */
+static bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    return (flags != -1) && (fcntl(fd, F_SETFL, flags | O_NONBLOCK) != -1);
+}
+
+/**
+ * Constructs connection.
+ * @param fd Socket of the connection.
+ */
+LookupServer::Connection::Connection(int fd)
+    : fd(fd), inputSize(0), output(OUTPUT_SIZE), events(EPOLLIN), protocol(PROTOCOL_UNKNOWN),
+      family(0), remaining(0), closing(false)
+{
+    input = new char[READ_SIZE + 1];
+}
+
+/**
+ * Destructor, closes the socket.
+ */
+LookupServer::Connection::~Connection()
+{
+    close(fd);
+    delete[] input;
+}
+
+/**
+ * Constructs server, socket is opened by open().
+ * @param tables Holder of the searched tables.
+ */
+LookupServer::LookupServer(TableReloader &tables)
+    : _tables(tables), _listenFd(-1), _signalFd(-1), _epollFd(-1), _reader(NULL), _accepted(0)
+{
+}
+
+/**
+ * Destructor, closes all connections and the socket.
+ */
+LookupServer::~LookupServer()
+{
+    for (size_t fd = 0; fd < _connections.size(); fd++) {
+        delete _connections[fd];
+    }
+
+    if (_listenFd != -1) {
+        close(_listenFd);
+    }
+    if (!_socketPath.empty()) {
+        unlink(_socketPath.c_str());
+    }
+    if (_signalFd != -1) {
+        close(_signalFd);
+    }
+    if (_epollFd != -1) {
+        close(_epollFd);
+    }
+}
+
+/**
+ * Opens listening socket. SIGINT and SIGTERM are blocked in the calling
+ * thread, so it has to be called before other threads are created.
+ * @param address Path of the Unix domain socket (contains '/'), or
+ *                TCP port optionally preceded by "host:" (localhost by default).
+ * @return True if the socket is listening, else false.
+ */
+bool LookupServer::open(const string &address) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+
+    // Stop signals are received only through the descriptor of the event loop
+    if (pthread_sigmask(SIG_BLOCK, &signals, NULL) != 0) {
+        return false;
+    }
+    _signalFd = signalfd(-1, &signals, 0);
+
+    // Client which disconnects before it gets answers must not kill the server
+    signal(SIGPIPE, SIG_IGN);
+
+    _listenFd = (address.find('/') != string::npos) ? openUnix(address) : openTcp(address);
+    _epollFd = epoll_create(MAX_EVENTS);
+    if ((_listenFd == -1) || (_signalFd == -1) || (_epollFd == -1) || !setNonBlocking(_listenFd)) {
+        return false;
+    }
+
+    /* Listening socket and signals are distinguished from connections by their descriptor. */
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = _listenFd;
+    if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, _listenFd, &event) == -1) {
+        return false;
+    }
+    event.data.fd = _signalFd;
+    return epoll_ctl(_epollFd, EPOLL_CTL_ADD, _signalFd, &event) != -1;
+}
+
+/**
+ * Opens Unix domain socket, stale socket file is replaced.
+ * @param path Path of the socket.
+ * @return Listening socket or -1 if error occurs.
+ */
+int LookupServer::openUnix(const string &path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    if (path.size() >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, path.c_str(), path.size());
+
+    // Socket left by the previous run is removed, other files are kept
+    struct stat fileStat;
+    if ((lstat(path.c_str(), &fileStat) == 0) && S_ISSOCK(fileStat.st_mode)) {
+        unlink(path.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) {
+        return -1;
+    }
+
+    if ((bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == -1) || (listen(fd, BACKLOG) == -1)) {
+        close(fd);
+        return -1;
+    }
+
+    _socketPath = path;
+    return fd;
+}
+
+/**
+ * Opens TCP socket.
+ * @param address Port optionally preceded by "host:", IPv6 host is enclosed in brackets.
+ * @return Listening socket or -1 if error occurs.
+ */
+int LookupServer::openTcp(const string &address) {
+    string host = DEFAULT_HOST;
+    string port = address;
+
+    size_t delim = address.rfind(':');
+    if (delim != string::npos) {
+        host = address.substr(0, delim);
+        port = address.substr(delim + 1);
+        if ((host.size() >= 2) && (host[0] == '[') && (host[host.size() - 1] == ']')) {
+            host = host.substr(1, host.size() - 2);
+        }
+    }
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+
+    struct addrinfo *addrs;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &addrs) != 0) {
+        return -1;
+    }
+
+    int fd = socket(addrs->ai_family, addrs->ai_socktype, addrs->ai_protocol);
+    if (fd != -1) {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        if ((bind(fd, addrs->ai_addr, addrs->ai_addrlen) == -1) || (listen(fd, BACKLOG) == -1)) {
+            close(fd);
+            fd = -1;
+        }
+    }
+
+    freeaddrinfo(addrs);
+    return fd;
+}
+
+/**
+ * Serves connections until SIGINT or SIGTERM is received.
+ * @return True if the server has been stopped by signal, false if waiting for events has failed.
+ */
+bool LookupServer::run() {
+    struct epoll_event events[MAX_EVENTS];
+    bool stopped = false;
+
+    _reader = _tables.registerReader();
+    while (!stopped) {
+        int count = epoll_wait(_epollFd, events, MAX_EVENTS, -1);
+        if (count == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        for (int i = 0; i < count; i++) {
+            int fd = events[i].data.fd;
+
+            if (fd == _signalFd) {
+                stopped = true;
+            } else if (fd == _listenFd) {
+                acceptConnections();
+            } else if (!serve(*_connections[fd], events[i].events)) {
+                closeConnection(_connections[fd]);
+            }
+        }
+    }
+    _tables.unregisterReader(_reader);
+    _reader = NULL;
+
+    return stopped;
+}
+
+/**
+ * Accepts all pending connections.
+ */
+void LookupServer::acceptConnections() {
+    int fd;
+
+    while ((fd = accept(_listenFd, NULL, NULL)) != -1) {
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+
+        if ((size_t)fd >= _connections.size()) {
+            _connections.resize(fd + 1, NULL);
+        }
+        Connection *conn = new Connection(fd);
+
+        struct epoll_event event;
+        event.events = conn->events;
+        event.data.fd = fd;
+        if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+            delete conn;
+            continue;
+        }
+
+        _connections[fd] = conn;
+        _accepted++;
+    }
+}
+
+/**
+ * Reads from the connection, answers received requests and sends answers.
+ * @param conn Connection with the event.
+ * @param events Received events.
+ * @return False if the connection should be closed, else true.
+ */
+bool LookupServer::serve(Connection &conn, uint32_t events) {
+    if ((events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !conn.closing) {
+        ssize_t read_bytes = read(conn.fd, &conn.input[conn.inputSize], READ_SIZE - conn.inputSize);
+
+        if (read_bytes == 0) {
+            conn.closing = true;
+
+            // Last line without new line character is answered too, incomplete binary frame is dropped
+            if ((conn.protocol == PROTOCOL_TEXT) && (conn.inputSize != 0)) {
+                conn.input[conn.inputSize++] = '\n';
+                process(conn, *_tables.readLock(_reader));
+                _tables.readUnlock(_reader);
+            }
+        } else if (read_bytes > 0) {
+            conn.inputSize += read_bytes;
+
+            // Tables are held only while the received requests are answered
+            bool processed = process(conn, *_tables.readLock(_reader));
+            _tables.readUnlock(_reader);
+
+            if (!processed) {      // Answers of the valid requests are still sent
+                conn.closing = true;
+            }
+        } else if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+            return false;
+        }
+    }
+
+    if (!conn.output.writeSome(conn.fd)) {
+        return false;
+    }
+
+    // Client which does not receive its answers is not read, so the output does not grow without limit
+    uint32_t wanted = 0;
+    if (!conn.closing && (conn.output.getSize() < MAX_PENDING)) {
+        wanted |= EPOLLIN;
+    }
+    if (conn.output.getSize() != 0) {
+        wanted |= EPOLLOUT;
+    }
+
+    // Closed client has received all answers
+    return (wanted != 0) && setEvents(conn, wanted);
+}
+
+/**
+ * Answers all complete requests of the input, incomplete rest stays in input.
+ * @param conn Connection with the received requests.
+ * @param tables Current tables.
+ * @return False if the request is malformed or too long, else true.
+ */
+bool LookupServer::process(Connection &conn, const TableSet &tables) {
+    if (conn.protocol == PROTOCOL_UNKNOWN) {
+        // Binary header starts with the family number, text line never does
+        conn.protocol = ((conn.input[0] == 4) || (conn.input[0] == 6)) ? PROTOCOL_BINARY : PROTOCOL_TEXT;
+    }
+
+    size_t processed;
+    if (conn.protocol == PROTOCOL_TEXT) {
+        char *rest;
+        conn.input[conn.inputSize] = '\0';
+
+        _searcher.setTables(*tables.ipv4, *tables.ipv6);
+        if (!_searcher.searchBlock(conn.input, conn.inputSize, rest, conn.output) || !_searcher.finish(conn.output)) {
+            return false;
+        }
+        processed = rest - conn.input;
+    } else {
+        long binaryProcessed = processBinary(conn, tables);
+        if (binaryProcessed == -1) {
+            return false;
+        }
+        processed = binaryProcessed;
+    }
+
+    // Incomplete request is moved to the beginning, request longer than the buffer is refused
+    conn.inputSize -= processed;
+    memmove(conn.input, &conn.input[processed], conn.inputSize);
+    return conn.inputSize != READ_SIZE;
+}
+
+/**
+ * Answers addresses of the binary frames.
+ * @param conn Connection with the received frames.
+ * @param tables Current tables.
+ * @return Number of the processed bytes, or -1 if the frame is malformed.
+ */
+long LookupServer::processBinary(Connection &conn, const TableSet &tables) {
+    char *pos = conn.input;
+    char *end = conn.input + conn.inputSize;
+
+    while (true) {
+        if (conn.remaining == 0) {
+            /* Start of the frame, header is sent back before the ASNs. */
+            uint32_t header;
+            if ((size_t)(end - pos) < HEADER_SIZE) {
+                break;
+            }
+            memcpy(&header, pos, HEADER_SIZE);
+            pos += HEADER_SIZE;
+
+            conn.family = ntohl(header) >> 24;
+            conn.remaining = ntohl(header) & 0xFFFFFF;
+            if (((conn.family != 4) && (conn.family != 6)) || (conn.remaining > MAX_FRAME)) {
+                return -1;
+            }
+
+            if (!conn.output.reserve(HEADER_SIZE)) {
+                return -1;
+            }
+            memcpy(conn.output.getPos(), &header, HEADER_SIZE);
+            conn.output.setPos(conn.output.getPos() + HEADER_SIZE);
+            continue;
+        }
+
+        /* Addresses which have been received are searched, frame may continue in the next read. */
+        AddrLookupBase &trie = (conn.family == 4) ? *tables.ipv4 : *tables.ipv6;
+        size_t words = trie.getAddrWords();
+        size_t count = (end - pos) / (words * sizeof(uint32_t));
+        if (count > conn.remaining) {
+            count = conn.remaining;
+        }
+        if (count > BINARY_BATCH) {
+            count = BINARY_BATCH;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        memcpy(_addrs, pos, count * words * sizeof(uint32_t));
+        for (size_t i = 0; i < count * words; i++) {
+            _addrs[i] = ntohl(_addrs[i]);
+        }
+        pos += count * words * sizeof(uint32_t);
+        conn.remaining -= count;
+
+        trie.longestPrefixMatchBatch(_addrs, count, _asns);
+
+        if (!conn.output.reserve(count * sizeof(uint32_t))) {
+            return -1;
+        }
+        for (size_t i = 0; i < count; i++) {
+            _asns[i] = htonl(_asns[i]);
+        }
+        memcpy(conn.output.getPos(), _asns, count * sizeof(uint32_t));
+        conn.output.setPos(conn.output.getPos() + count * sizeof(uint32_t));
+    }
+
+    return pos - conn.input;
+}
+
+/**
+ * Changes events the connection waits for.
+ * @param conn Connection whose events should be changed.
+ * @param events New events.
+ * @return True if no error occurs, else false.
+ */
+bool LookupServer::setEvents(Connection &conn, uint32_t events) {
+    if (conn.events == events) {
+        return true;
+    }
+
+    struct epoll_event event;
+    event.events = events;
+    event.data.fd = conn.fd;
+    conn.events = events;
+
+    return epoll_ctl(_epollFd, EPOLL_CTL_MOD, conn.fd, &event) != -1;
+}
+
+/**
+ * Closes the connection and frees it.
+ * @param conn Connection which should be closed.
+ */
+void LookupServer::closeConnection(Connection *conn) {
+    _connections[conn->fd] = NULL;
+    delete conn;            // Closed socket is removed from epoll
+}
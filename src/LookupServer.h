@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       LookupServer.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines server answering lookups over sockets.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file LookupServer.h
+ *
+ * @brief Defines server answering lookups over sockets.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef LOOKUPSERVER_H
+#define LOOKUPSERVER_H
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "LineSearcher.h"
+#include "OutputBuffer.h"
+#include "TableReloader.h"
+
+using namespace std;
+
+/**
+ * Server which answers lookups of many clients over Unix domain or TCP socket
+ * from the tables loaded once. All connections are served by single thread
+ * through epoll, tables are read inside RCU critical section, so they can be
+ * reloaded and updated meanwhile.
+ *
+ * Protocol of the connection is chosen by its first byte. Text connection
+ * sends lines with addresses and receives line with ASN (or '-') for each of
+ * them, the same as stdin and stdout, last line without new line character
+ * is answered when the client closes its side. Binary connection sends frames which
+ * start with 32 bit header in network order, upper 8 bits are the address
+ * family (4 or 6) and lower 24 bits the number of the addresses, followed by
+ * the addresses (4 or 16 bytes in network order), frame holds at most
+ * MAX_FRAME addresses. Response repeats the header followed by 32 bit ASN
+ * in network order for each address, 0 if no prefix matched. Connection is
+ * not read while it has more than MAX_PENDING bytes of unsent answers,
+ * malformed or too long request closes it after the previous answers are sent.
+ */
+class LookupServer
+{
+public:
+    /**
+     * Constructs server, socket is opened by open().
+     * @param tables Holder of the searched tables.
+     */
+    LookupServer(TableReloader &tables);
+
+    /**
+     * Destructor, closes all connections and the socket.
+     */
+    ~LookupServer();
+
+    /**
+     * Opens listening socket. SIGINT and SIGTERM are blocked in the calling
+     * thread, so it has to be called before other threads are created.
+     * @param address Path of the Unix domain socket (contains '/'), or
+     *                TCP port optionally preceded by "host:" (localhost by default).
+     * @return True if the socket is listening, else false.
+     */
+    bool open(const string &address);
+
+    /**
+     * Serves connections until SIGINT or SIGTERM is received.
+     * @return True if the server has been stopped by signal, false if waiting for events has failed.
+     */
+    bool run();
+
+    /**
+     * Returns number of the accepted connections.
+     * @return Number of the accepted connections.
+     */
+    inline size_t getAccepted() const {
+        return _accepted;
+    }
+
+    const static size_t READ_SIZE = 65536;    /**< Size of the input buffer of the connection */
+    const static size_t OUTPUT_SIZE = 4096;   /**< Initial size of the output buffer of the connection */
+    const static size_t BINARY_BATCH = 4096;  /**< Number of the binary addresses which are searched at once */
+    const static uint32_t MAX_FRAME = 65536;  /**< Maximal number of the addresses in binary frame */
+    const static size_t MAX_PENDING = 1048576; /**< Unsent answers which stop reading of the connection */
+    const static int MAX_EVENTS = 64;         /**< Number of the events handled by one wait */
+    const static int BACKLOG = 128;           /**< Length of the queue of the pending connections */
+
+private:
+    /**
+     * Protocols of the connection.
+     */
+    enum protocols {
+        PROTOCOL_UNKNOWN = 0, /**< No byte has been received yet */
+        PROTOCOL_TEXT = 1,    /**< Lines with addresses */
+        PROTOCOL_BINARY = 2   /**< Frames with packed addresses */
+                    };
+
+    /**
+     * Accepted client connection.
+     */
+    struct Connection {
+        int fd;                 /**< Socket of the connection */
+        char *input;            /**< Received bytes which have not been processed yet */
+        size_t inputSize;       /**< Number of the received bytes */
+        OutputBuffer output;    /**< Answers which have not been sent yet */
+        uint32_t events;        /**< Events the connection waits for */
+        int protocol;           /**< Protocol of the connection */
+        int family;             /**< Address family of the current binary frame */
+        uint32_t remaining;     /**< Addresses of the current binary frame which have not been received */
+        bool closing;           /**< Client has closed its side, connection is closed when answers are sent */
+
+        /**
+         * Constructs connection.
+         * @param fd Socket of the connection.
+         */
+        Connection(int fd);
+
+        /**
+         * Destructor, closes the socket.
+         */
+        ~Connection();
+    };
+
+    TableReloader &_tables;           /**< Holder of the searched tables */
+    int _listenFd;                    /**< Listening socket */
+    int _signalFd;                    /**< Descriptor receiving SIGINT and SIGTERM */
+    int _epollFd;                     /**< Epoll instance */
+    RcuReader *_reader;               /**< Reader of the tables registered by run() */
+    string _socketPath;               /**< Path of the Unix domain socket, removed on exit */
+    vector<Connection *> _connections; /**< Connections indexed by their socket */
+    size_t _accepted;                 /**< Number of the accepted connections */
+    LineSearcher _searcher;           /**< Searcher of the text lines, batch is empty between events */
+    uint32_t _addrs[BINARY_BATCH * 4]; /**< Converted binary addresses, IPv6 needs 4 words */
+    uint32_t _asns[BINARY_BATCH];     /**< Found ASNs of the binary addresses */
+
+    /**
+     * Opens Unix domain socket, stale socket file is replaced.
+     * @param path Path of the socket.
+     * @return Listening socket or -1 if error occurs.
+     */
+    int openUnix(const string &path);
+
+    /**
+     * Opens TCP socket.
+     * @param address Port optionally preceded by "host:", IPv6 host is enclosed in brackets.
+     * @return Listening socket or -1 if error occurs.
+     */
+    int openTcp(const string &address);
+
+    /**
+     * Accepts all pending connections.
+     */
+    void acceptConnections();
+
+    /**
+     * Reads from the connection, answers received requests and sends answers.
+     * @param conn Connection with the event.
+     * @param events Received events.
+     * @return False if the connection should be closed, else true.
+     */
+    bool serve(Connection &conn, uint32_t events);
+
+    /**
+     * Answers all complete requests of the input, incomplete rest stays in input.
+     * @param conn Connection with the received requests.
+     * @param tables Current tables.
+     * @return False if the request is malformed or too long, else true.
+     */
+    bool process(Connection &conn, const TableSet &tables);
+
+    /**
+     * Answers addresses of the binary frames.
+     * @param conn Connection with the received frames.
+     * @param tables Current tables.
+     * @return Number of the processed bytes, or -1 if the frame is malformed.
+     */
+    long processBinary(Connection &conn, const TableSet &tables);
+
+    /**
+     * Changes events the connection waits for.
+     * @param conn Connection whose events should be changed.
+     * @param events New events.
+     * @return True if no error occurs, else false.
+     */
+    bool setEvents(Connection &conn, uint32_t events);
+
+    /**
+     * Closes the connection and frees it.
+     * @param conn Connection which should be closed.
+     */
+    void closeConnection(Connection *conn);
+
+    LookupServer(const LookupServer &);
+    LookupServer &operator=(const LookupServer &);
+};
+
+#endif // LOOKUPSERVER_H
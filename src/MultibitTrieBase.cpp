@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       MultibitTrieBase.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing multibit searching trie.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file MultibitTrieBase.cpp
+ *
+ * @brief Implements multibit searching trie.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstdlib>
+#include <cstring>
+
+#include "MultibitTrieBase.h"
+
+/*
+ * Default strides, IPv4 needs at most 3 memory accesses,
+ * IPv6 strides keeps the nodes under /16 small because IPv6 table is sparse.
+ */
+const char *MultibitTrieBase::DEFAULT_IPV4_STRIDES = "16,8,8";
+const char *MultibitTrieBase::DEFAULT_IPV6_STRIDES = "16,8,8,8,8,8,8,8,8,8,8,8,8,8,8";
+
+/**
+ * Maximal supported stride, larger would make nodes too big.
+ */
+const static int MAX_STRIDE = 24;
+
+/**
+ * Constructs multibit search trie.
+ * @param familyInfo Informations about addresses which will this trie accept.
+ * @param strides Comma separated strides of the levels (e.g. "16,8,8"),
+ *        default strides of the family are used when NULL or invalid.
+ */
+MultibitTrieBase::MultibitTrieBase(FamilyInfoBase *familyInfo, const char *strides)
+    : AddrLookupBase(familyInfo), rootNode(0), _prefixCount(0), _nodeCount(0), _nodeBytes(0)
+{
+    _words = getAddrWords();
+
+    if ((strides == 0) || !setStrides(strides)) {
+        setStrides((familyInfo->getAddrBitLength() == 32) ? DEFAULT_IPV4_STRIDES : DEFAULT_IPV6_STRIDES);
+    }
+}
+
+/**
+ * Destructor of the trie.
+ */
+MultibitTrieBase::~MultibitTrieBase()
+{
+    release();
+}
+
+/**
+ * Sets strides of the trie levels, trie has to be empty.
+ * @param strides Comma separated strides of the levels (e.g. "16,8,8").
+ * @return True if strides are valid and sum to the address length, else false.
+ */
+bool MultibitTrieBase::setStrides(const char *strides) {
+    vector<uint8_t> parsed;
+    int sum = 0;
+
+    while (*strides != '\0') {
+        char *end;
+        long stride = strtol(strides, &end, 10);
+        if ((end == strides) || (stride < 1) || (stride > MAX_STRIDE)) {
+            return false;
+        }
+
+        parsed.push_back(stride);
+        sum += stride;
+
+        strides = (*end == ',') ? end + 1 : end;
+        if ((*end != ',') && (*end != '\0')) {
+            return false;
+        }
+    }
+
+    if (sum != familyInfo->getAddrBitLength()) {
+        return false;
+    }
+
+    release();
+    _strides = parsed;
+    rootNode = newNode(0);
+    return true;
+}
+
+/**
+ * Inserts new ASN into trie.
+ * @param addr Address which should be inserted.
+ * @param prefix Defines how many bits should be stored into trie.
+ * @param asn Number of the autonomous system to be stored in destination entries.
+ * @return True if no error occurs, else false.
+ */
+bool MultibitTrieBase::insertASN(uint32_t *addr, int prefix, uint32_t asn) {
+    MultibitEntry *currNode = rootNode;
+    int pos = 0;
+
+    if ((prefix < 0) || (prefix > familyInfo->getAddrBitLength()) || (asn == NO_ASN)) {
+        return false;
+    }
+
+    /* Walks through the levels until the level where prefix ends */
+    for (int level = 0; 1; level++) {
+        int stride = _strides[level];
+
+        if (prefix <= pos + stride) { // Prefix ends in this level, expand it into all covered entries
+            int fixedBits = prefix - pos;
+            uint32_t first = (fixedBits == 0) ? 0 : extractBits(addr, _words, pos, fixedBits) << (stride - fixedBits);
+            uint32_t count = 1 << (stride - fixedBits);
+
+            uint32_t *present = getPresentBitmap(currNode, level);
+            uint32_t bit = (1 << fixedBits) | (first >> (stride - fixedBits));
+            if (present[bit >> 5] & (1U << (bit & 31))) {
+                return false;         // Same prefix is already stored
+            }
+            present[bit >> 5] |= 1U << (bit & 31);
+            _prefixCount++;
+
+            /* Longer prefixes which has been already expanded here have precedence */
+            for (MultibitEntry *entry = &currNode[first]; entry != &currNode[first + count]; entry++) {
+                if ((entry->value == NO_ASN) || (entry->length < prefix)) {
+                    entry->value = asn;
+                    entry->length = prefix;
+                }
+            }
+
+            return true;
+        }
+
+        MultibitEntry *entry = &currNode[extractBits(addr, _words, pos, stride)];
+        if (entry->child == 0) {       // There is no child yet, create a new one
+            entry->child = newNode(level + 1);
+        }
+
+        currNode = entry->child;
+        pos += stride;
+    }
+}
+
+/**
+ * Allocates new empty node of the specified level.
+ * @param level Level of the node.
+ * @return New node.
+ */
+MultibitEntry *MultibitTrieBase::newNode(int level) {
+    size_t bytes = (1 << _strides[level]) * sizeof(MultibitEntry) + getPresentBitmapSize(level);
+
+    _nodeCount++;
+    _nodeBytes += bytes;
+
+    // Entries are followed by the bitmap of the stored prefixes, so lookup touches only the entries
+    return reinterpret_cast<MultibitEntry *>(new char[bytes]());
+}
+
+/**
+ * Returns size of the bitmap of the prefixes stored in the node of the level.
+ * @param level Level of the node.
+ * @return Size of the bitmap in bytes.
+ */
+size_t MultibitTrieBase::getPresentBitmapSize(int level) const {
+    return (_strides[level] < 5) ? sizeof(uint32_t) : ((size_t)1 << (_strides[level] + 1)) / 8;
+}
+
+/**
+ * Clears all trie/removes from the memory.
+ */
+void MultibitTrieBase::clear() {
+    release();
+    rootNode = newNode(0);   // Trie is always ready for inserting
+}
+
+/**
+ * Removes all nodes from the memory including the root node.
+ */
+void MultibitTrieBase::release() {
+    if (rootNode != 0) {
+        clearProtected(rootNode, 0);
+    }
+    rootNode = 0;
+    _nodeCount = 0;
+    _nodeBytes = 0;
+    _prefixCount = 0;
+}
+
+/**
+ * Fills statistics about the content and memory usage of the trie.
+ * @param stats Structure which will be filled.
+ */
+void MultibitTrieBase::getStats(LookupStats &stats) const {
+    stats.prefixes = _prefixCount;
+    stats.nodes = _nodeCount;
+    stats.bytes = _nodeBytes;
+    stats.uncompressedNodes = 0;
+    stats.uncompressedBytes = 0;
+}
+
+/**
+ * Clears all nodes recursive from the specified node.
+ * @param node Node from which should be all other nodes removed.
+ * @param level Level of the node.
+ */
+void MultibitTrieBase::clearProtected(MultibitEntry *node, int level) {
+    if (node != 0) {
+        int count = 1 << _strides[level];
+        for (int i = 0; i < count; i++) {
+            clearProtected(node[i].child, level + 1);
+        }
+
+        delete[] reinterpret_cast<char *>(node);
+    }
+}
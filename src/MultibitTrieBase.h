@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       MultibitTrieBase.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines multibit searching trie base class.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file MultibitTrieBase.h
+ *
+ * @brief Defines multibit searching trie base class.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef MULTIBITTRIEBASE_H
+#define MULTIBITTRIEBASE_H
+
+#include <vector>
+
+#include "AddrLookupBase.h"
+
+using namespace std;
+
+/**
+ * Entry of the multibit trie node. Node is an array of 2^stride entries.
+ */
+struct MultibitEntry {
+    MultibitEntry *child;   /**< Child node (array of entries) of the next level */
+    uint32_t value;         /**< Value (ASN) of the longest prefix expanded into this entry, 0 means none */
+    uint8_t length;         /**< Length of the prefix whose value is stored in this entry */
+};
+
+/**
+ * Class of the multibit searching trie. Each level of the trie consumes
+ * configurable number of bits (stride) and prefixes which do not end on
+ * the stride boundary are expanded (controlled prefix expansion).
+ */
+class MultibitTrieBase : public AddrLookupBase
+{
+public:
+    /**
+     * Constructs multibit search trie.
+     * @param familyInfo Informations about addresses which will this trie accept.
+     * @param strides Comma separated strides of the levels (e.g. "16,8,8"),
+     *        default strides of the family are used when NULL or invalid.
+     */
+    MultibitTrieBase(FamilyInfoBase *familyInfo, const char *strides = 0);
+
+    /**
+     * Destructor of the trie.
+     */
+    virtual ~MultibitTrieBase();
+
+    using AddrLookupBase::insertASN;
+    using AddrLookupBase::longestPrefixMatch;
+
+    /**
+     * Sets strides of the trie levels, trie has to be empty.
+     * @param strides Comma separated strides of the levels (e.g. "16,8,8").
+     * @return True if strides are valid and sum to the address length, else false.
+     */
+    bool setStrides(const char *strides);
+
+    /**
+     * Inserts new ASN into trie.
+     * @param addr Address which should be inserted.
+     * @param prefix Defines how many bits should be stored into trie.
+     * @param asn Number of the autonomous system to be stored in destination entries.
+     * @return True if no error occurs, else false.
+     */
+    virtual bool insertASN(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Searches address inside the trie and tries to find the corresponding ASN.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual inline uint32_t longestPrefixMatch(uint32_t *addr) {
+        MultibitEntry *currNode = rootNode;
+        uint32_t ret_value = NO_ASN;
+        int pos = 0;
+
+        /* Every level consumes whole stride of the address */
+        for (int level = 0; 1; level++) {
+            MultibitEntry *entry = &currNode[extractBits(addr, _words, pos, _strides[level])];
+
+            if (entry->value != NO_ASN) { // Currently longest corresponding ASN, try to find a better one on the next level
+                ret_value = entry->value;
+            }
+
+            currNode = entry->child;
+            if (currNode == 0) {     // There is no path, return with the last found value
+                break;
+            }
+
+            pos += _strides[level];
+        }
+
+        return ret_value;
+    }
+
+    /**
+     * Clears all trie/removes from the memory.
+     */
+    virtual void clear();
+
+    /**
+     * Fills statistics about the content and memory usage of the trie.
+     * @param stats Structure which will be filled.
+     */
+    virtual void getStats(LookupStats &stats) const;
+
+    const static char *DEFAULT_IPV4_STRIDES;
+    const static char *DEFAULT_IPV6_STRIDES;
+
+protected:
+    MultibitEntry *rootNode;     /**< Root node of the trie */
+
+    /**
+     * Allocates new empty node of the specified level.
+     * @param level Level of the node.
+     * @return New node.
+     */
+    MultibitEntry *newNode(int level);
+
+    /**
+     * Returns size of the bitmap of the prefixes stored in the node of the level.
+     * Bitmap has bit for every prefix ending in the node, bit of the prefix with
+     * n bits in the node is (1 << n) | bits.
+     * @param level Level of the node.
+     * @return Size of the bitmap in bytes.
+     */
+    size_t getPresentBitmapSize(int level) const;
+
+    /**
+     * Returns bitmap of the prefixes stored in the node, it is placed behind the entries.
+     * @param node Node whose bitmap should be returned.
+     * @param level Level of the node.
+     * @return Bitmap of the stored prefixes.
+     */
+    inline uint32_t *getPresentBitmap(MultibitEntry *node, int level) const {
+        return reinterpret_cast<uint32_t *>(node + (1 << _strides[level]));
+    }
+
+    /**
+     * Clears all nodes recursive from the specified node.
+     * @param node Node from which should be all other nodes removed.
+     * @param level Level of the node.
+     */
+    void clearProtected(MultibitEntry *node, int level);
+
+    /**
+     * Removes all nodes from the memory including the root node.
+     */
+    void release();
+
+private:
+    vector<uint8_t> _strides;    /**< Strides of the levels */
+    size_t _prefixCount;         /**< Number of stored prefixes */
+    size_t _nodeCount;           /**< Number of the allocated nodes */
+    size_t _nodeBytes;           /**< Memory used by all allocated nodes */
+    int _words;                  /**< Number of 32 bit words of the address */
+};
+
+#endif // MULTIBITTRIEBASE_H
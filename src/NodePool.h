@@ -0,0 +1,343 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       NodePool.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines pool of the trie nodes.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file NodePool.h
+ *
+ * @brief Defines pool of the trie nodes.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <stdint.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <new>
+#include <vector>
+
+#include "Rcu.h"
+
+/**
+ * Pool which keeps all nodes in one continuous array, nodes are referenced
+ * by their 32 bit index into the array. Array grows by doubling, so indices
+ * stay valid even when the array is moved. Released nodes are reused by the
+ * next allocations, the array itself is freed at once.
+ * Node has to be plain structure which can be moved by memcpy().
+ *
+ * Pool with reclaim domain can be read by the readers of the domain while
+ * single writer modifies it. Grown array is published by release store and
+ * the old array, as well as released nodes, is reused or freed after all
+ * readers which could see it have left their critical sections.
+ */
+template<class Node>
+class NodePool
+{
+public:
+    /**
+     * Constructs empty pool.
+     */
+    NodePool() : _nodes(0), _size(0), _capacity(0), _attached(false), _rcu(0) {}
+
+    /**
+     * Destructor of the pool, frees all nodes.
+     */
+    ~NodePool() {
+        clear();
+    }
+
+    /**
+     * Allocates new node constructed by default constructor.
+     * Pointers to the nodes are invalidated, indices remain valid.
+     * @return Index of the new node.
+     */
+    inline uint32_t allocate() {
+        if (_free.empty() && (!_retired.empty() || !_retiredArrays.empty())) {
+            reclaim();
+        }
+
+        if (!_free.empty()) {  // Released node is reused first
+            uint32_t index = _free.back();
+            _free.pop_back();
+            new (&_nodes[index]) Node();
+            return index;
+        }
+
+        if (_size == _capacity) {
+            grow(_size + 1);
+        }
+
+        new (&_nodes[_size]) Node();
+        return _size++;
+    }
+
+    /**
+     * Releases node which is not referenced anymore, it is reused by the next
+     * allocations. With reclaim domain node waits until no reader can see it.
+     * @param index Index of the node.
+     */
+    inline void release(uint32_t index) {
+        if (_rcu == 0) {
+            _free.push_back(index);
+            return;
+        }
+
+        _retired.push_back(RetiredNode(index, _rcu->advance()));
+        reclaim();
+    }
+
+    /**
+     * Appends copies of all nodes of the other pool, indices stored
+     * inside the copied nodes have to be moved by the returned offset.
+     * @param other Pool whose nodes should be copied.
+     * @return Index of the first copied node.
+     */
+    uint32_t append(const NodePool &other) {
+        uint32_t offset = _size;
+
+        if (other._size > _capacity - _size) {
+            grow(_size + other._size);
+        }
+
+        if (other._size != 0) {
+            memcpy(&_nodes[_size], other._nodes, (size_t)other._size * sizeof(Node));
+        }
+        _size += other._size;
+
+        return offset;
+    }
+
+    /**
+     * Returns node stored under the index.
+     * @param index Index of the node.
+     * @return Node stored under the index.
+     */
+    inline Node &operator[](uint32_t index) {
+        return _nodes[index];
+    }
+
+    /**
+     * Returns node stored under the index.
+     * @param index Index of the node.
+     * @return Node stored under the index.
+     */
+    inline const Node &operator[](uint32_t index) const {
+        return _nodes[index];
+    }
+
+    /**
+     * Returns array with all nodes, it is valid until next allocation
+     * or, with reclaim domain, until the end of the critical section.
+     * @return Array with all nodes.
+     */
+    inline const Node *getNodes() const {
+        return __atomic_load_n(&_nodes, __ATOMIC_ACQUIRE);
+    }
+
+    /**
+     * Returns number of the nodes in array, including the released ones.
+     * @return Number of the nodes in array.
+     */
+    inline uint32_t size() const {
+        return _size;
+    }
+
+    /**
+     * Returns number of the released nodes which wait for reuse.
+     * @return Number of the released nodes.
+     */
+    inline uint32_t getFreeCount() const {
+        return _free.size() + _retired.size();
+    }
+
+    /**
+     * Returns memory reserved by the pool.
+     * @return Memory reserved by the pool in bytes.
+     */
+    inline size_t getBytes() const {
+        return (size_t)_capacity * sizeof(Node);
+    }
+
+    /**
+     * Frees all nodes at once, attached array is only released.
+     * Pool must not be read by anyone meanwhile.
+     */
+    void clear() {
+        if (!_attached) {
+            free(_nodes);
+        }
+        _nodes = 0;
+        _size = 0;
+        _capacity = 0;
+        _attached = false;
+        std::vector<uint32_t>().swap(_free);
+        _retired.clear();
+
+        while (!_retiredArrays.empty()) {
+            free(_retiredArrays.front().nodes);
+            _retiredArrays.pop_front();
+        }
+    }
+
+    /**
+     * Uses external read-only array of the nodes (e.g. mapped from the file)
+     * instead of the own one. Pool does not own the array and nodes cannot
+     * be allocated until the pool is cleared or detached.
+     * @param nodes Array with the nodes.
+     * @param size Number of the nodes in array.
+     */
+    void attach(const Node *nodes, uint32_t size) {
+        clear();
+        _nodes = const_cast<Node *>(nodes);
+        _size = size;
+        _capacity = size;
+        _attached = true;
+    }
+
+    /**
+     * Copies attached array into own memory, so the nodes can be modified.
+     */
+    void detach() {
+        if (!_attached) {
+            return;
+        }
+
+        uint32_t capacity = nextCapacity(_size);
+        Node *nodes = (capacity == 0) ? 0 : static_cast<Node *>(malloc((size_t)capacity * sizeof(Node)));
+        if (nodes == 0) {
+            throw std::bad_alloc();
+        }
+        memcpy(nodes, _nodes, (size_t)_size * sizeof(Node));
+
+        // External array is owned by someone else, it is not retired
+        __atomic_store_n(&_nodes, nodes, __ATOMIC_RELEASE);
+        _capacity = capacity;
+        _attached = false;
+    }
+
+    /**
+     * Tests whether the pool uses external read-only array.
+     * @return True if the array is attached, else false.
+     */
+    inline bool isAttached() const {
+        return _attached;
+    }
+
+    /**
+     * Sets domain whose readers read the pool concurrently with the writer.
+     * @param rcu Reclaim domain, or NULL if the pool is not read concurrently.
+     */
+    inline void setReclaimDomain(RcuDomain *rcu) {
+        _rcu = rcu;
+    }
+
+private:
+    /**
+     * Released node which waits for the end of the grace period.
+     */
+    struct RetiredNode {
+        uint32_t index;        /**< Index of the node */
+        uint64_t epoch;        /**< Epoch which has to pass */
+
+        RetiredNode(uint32_t index, uint64_t epoch) : index(index), epoch(epoch) {}
+    };
+
+    /**
+     * Replaced array which waits for the end of the grace period.
+     */
+    struct RetiredArray {
+        Node *nodes;           /**< Array with nodes */
+        uint64_t epoch;        /**< Epoch which has to pass */
+
+        RetiredArray(Node *nodes, uint64_t epoch) : nodes(nodes), epoch(epoch) {}
+    };
+
+    Node *_nodes;          /**< Array with nodes */
+    uint32_t _size;        /**< Number of allocated nodes */
+    uint32_t _capacity;    /**< Number of nodes which fits into array */
+    bool _attached;        /**< Array is external and read-only */
+    std::vector<uint32_t> _free; /**< Indices of the released nodes */
+    RcuDomain *_rcu;       /**< Domain of the concurrent readers, or NULL */
+    std::deque<RetiredNode> _retired;        /**< Released nodes in order of the epochs */
+    std::deque<RetiredArray> _retiredArrays; /**< Replaced arrays in order of the epochs */
+
+    /**
+     * Computes capacity of the array by doubling.
+     * @param minCapacity Required number of the nodes.
+     * @return New capacity, 0 on overflow.
+     */
+    inline uint32_t nextCapacity(uint32_t minCapacity) const {
+        uint32_t capacity = (_capacity == 0) ? INITIAL_CAPACITY : _capacity;
+        while ((capacity < minCapacity) && (capacity != 0)) {
+            capacity *= 2;     // Overflow to 0 when more than 2^32 nodes are required
+        }
+
+        return capacity;
+    }
+
+    /**
+     * Doubles capacity of the array until it holds required number of the nodes.
+     * @param minCapacity Required number of the nodes.
+     */
+    void grow(uint32_t minCapacity) {
+        uint32_t capacity = nextCapacity(minCapacity);
+
+        if (_attached) {       // External array cannot grow
+            throw std::bad_alloc();
+        }
+
+        Node *nodes;
+        if (_rcu == 0) {
+            nodes = (capacity == 0) ? 0 : static_cast<Node *>(realloc(_nodes, (size_t)capacity * sizeof(Node)));
+        } else {               // Readers can still walk the old array, it is copied
+            nodes = (capacity == 0) ? 0 : static_cast<Node *>(malloc((size_t)capacity * sizeof(Node)));
+            if (nodes != 0) {
+                memcpy(nodes, _nodes, (size_t)_size * sizeof(Node));
+            }
+        }
+
+        if ((nodes == 0) || (capacity <= _capacity)) {
+            throw std::bad_alloc();
+        }
+
+        Node *oldNodes = _nodes;
+        __atomic_store_n(&_nodes, nodes, __ATOMIC_RELEASE);
+        _capacity = capacity;
+
+        if ((_rcu != 0) && (oldNodes != 0)) {  // Epoch is advanced after the new array is published
+            _retiredArrays.push_back(RetiredArray(oldNodes, _rcu->advance()));
+        }
+    }
+
+    /**
+     * Reuses released nodes and frees replaced arrays whose grace period has ended.
+     */
+    void reclaim() {
+        while (!_retired.empty() && _rcu->passed(_retired.front().epoch)) {
+            _free.push_back(_retired.front().index);
+            _retired.pop_front();
+        }
+
+        while (!_retiredArrays.empty() && _rcu->passed(_retiredArrays.front().epoch)) {
+            free(_retiredArrays.front().nodes);
+            _retiredArrays.pop_front();
+        }
+    }
+
+    const static uint32_t INITIAL_CAPACITY = 1024;  /**< Number of the nodes allocated at first */
+
+    NodePool(const NodePool &);
+    NodePool &operator=(const NodePool &);
+};
+
+#endif // NODEPOOL_H
@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       OutputBuffer.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing buffer of the search results.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file OutputBuffer.cpp
+ *
+ * @brief Implements buffer of the search results.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <unistd.h>
+
+#include "OutputBuffer.h"
+#include "RuntimeStats.h"
+
+/**
+ * Constructs buffer.
+ * @param capacity Initial capacity of the buffer in bytes.
+ * @param fd File descriptor where is the buffer flushed, or -1 for unbound buffer.
+ */
+OutputBuffer::OutputBuffer(size_t capacity, int fd) : _fd(fd)
+{
+    _data = static_cast<char *>(malloc(capacity));
+    if (_data == 0) {
+        throw std::bad_alloc();
+    }
+
+    _pos = _data;
+    _end = _data + capacity;
+}
+
+/**
+ * Destructor of the buffer, does not flush the content.
+ */
+OutputBuffer::~OutputBuffer()
+{
+    free(_data);
+}
+
+/**
+ * Writes content of the buffer into file descriptor and empties the buffer.
+ * @param fd File descriptor where should be content written.
+ * @return True if no error occurs, else false.
+ */
+bool OutputBuffer::writeTo(int fd) {
+    char *data = _data;
+    LPM_STATS_START(start);
+
+    while (data != _pos) {   // Write could be partial, e.g. on pipes
+        ssize_t written = write(fd, data, _pos - data);
+        if (written == -1) {
+            return false;
+        }
+        data += written;
+    }
+
+    _pos = _data;
+    LPM_STATS_PHASE(PHASE_WRITE, start);
+    return true;
+}
+
+/**
+ * Writes as much of the content as the non-blocking file descriptor accepts,
+ * written content is removed from the buffer.
+ * @param fd File descriptor where should be content written.
+ * @return True if no error occurs, else false.
+ */
+bool OutputBuffer::writeSome(int fd) {
+    char *data = _data;
+
+    while (data != _pos) {
+        ssize_t written = write(fd, data, _pos - data);
+        if (written == -1) {
+            if ((errno != EAGAIN) && (errno != EWOULDBLOCK)) {
+                return false;
+            }
+            break;
+        }
+        data += written;
+    }
+
+    // Unwritten rest is moved to the beginning
+    memmove(_data, data, _pos - data);
+    _pos = _data + (_pos - data);
+    return true;
+}
+
+/**
+ * Flushes bound buffer or grows unbound buffer, so it has required free space.
+ * @param size Required free space in bytes.
+ * @return True if no error occurs, else false.
+ */
+bool OutputBuffer::makeSpace(size_t size) {
+    size_t used = _pos - _data;
+    size_t capacity = _end - _data;
+
+    if (_fd != -1) {                 // Bound buffer, free space by flushing
+        if (!writeTo(_fd)) {
+            return false;
+        }
+        used = 0;
+    }
+
+    if (capacity - used < size) {    // Space is still missing, grow the buffer
+        while (capacity - used < size) {
+            capacity *= 2;
+        }
+
+        char *data = static_cast<char *>(realloc(_data, capacity));
+        if (data == 0) {
+            throw std::bad_alloc();
+        }
+
+        _data = data;
+        _end = data + capacity;
+    }
+
+    _pos = _data + used;
+    return true;
+}
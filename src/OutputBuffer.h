@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       OutputBuffer.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines buffer of the search results.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file OutputBuffer.h
+ *
+ * @brief Defines buffer of the search results.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef OUTPUTBUFFER_H
+#define OUTPUTBUFFER_H
+
+#include <cstddef>
+
+/**
+ * Buffer where are the search results printed. Buffer bound to the file
+ * descriptor is flushed into it when it is getting full, unbound buffer
+ * grows and keeps all results in the memory until it is written at once.
+ */
+class OutputBuffer
+{
+public:
+    /**
+     * Constructs buffer.
+     * @param capacity Initial capacity of the buffer in bytes.
+     * @param fd File descriptor where is the buffer flushed, or -1 for unbound buffer.
+     */
+    OutputBuffer(size_t capacity, int fd = -1);
+
+    /**
+     * Destructor of the buffer, does not flush the content.
+     */
+    ~OutputBuffer();
+
+    /**
+     * Makes sure that the buffer has free space behind the current position.
+     * @param size Required free space in bytes.
+     * @return True if no error occurs, false if flushing has failed.
+     */
+    inline bool reserve(size_t size) {
+        return ((size_t)(_end - _pos) >= size) || makeSpace(size);
+    }
+
+    /**
+     * Returns current position where should be next results printed.
+     * @return Current position in the buffer.
+     */
+    inline char *getPos() const {
+        return _pos;
+    }
+
+    /**
+     * Moves current position behind the printed results.
+     * @param pos New position in the buffer.
+     */
+    inline void setPos(char *pos) {
+        _pos = pos;
+    }
+
+    /**
+     * Writes content of the buffer into file descriptor and empties the buffer.
+     * @param fd File descriptor where should be content written.
+     * @return True if no error occurs, else false.
+     */
+    bool writeTo(int fd);
+
+    /**
+     * Writes as much of the content as the non-blocking file descriptor accepts,
+     * written content is removed from the buffer.
+     * @param fd File descriptor where should be content written.
+     * @return True if no error occurs, else false.
+     */
+    bool writeSome(int fd);
+
+    /**
+     * Returns size of the content of the buffer.
+     * @return Size of the content in bytes.
+     */
+    inline size_t getSize() const {
+        return _pos - _data;
+    }
+
+    /**
+     * Writes content of the buffer into bound file descriptor.
+     * @return True if no error occurs, else false.
+     */
+    inline bool flush() {
+        return (_fd == -1) || writeTo(_fd);
+    }
+
+private:
+    char *_data;    /**< Allocated space of the buffer */
+    char *_pos;     /**< Current position */
+    char *_end;     /**< End of the allocated space */
+    int _fd;        /**< Bound file descriptor, or -1 */
+
+    /**
+     * Flushes bound buffer or grows unbound buffer, so it has required free space.
+     * @param size Required free space in bytes.
+     * @return True if no error occurs, else false.
+     */
+    bool makeSpace(size_t size);
+
+    OutputBuffer(const OutputBuffer &);
+    OutputBuffer &operator=(const OutputBuffer &);
+};
+
+#endif // OUTPUTBUFFER_H
@@ -0,0 +1,176 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       PatriciaTrieBase.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing path-compressed searching trie.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file PatriciaTrieBase.cpp
+ *
+ * @brief Implements path-compressed searching trie.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include "PatriciaTrieBase.h"
+#include "TrieNode.h"
+
+/**
+ * Returns length of the common prefix of two addresses.
+ * @param a First address.
+ * @param b Second address.
+ * @param maxLength Maximal length which is tested.
+ * @return Length of the common prefix, at most maxLength.
+ */
+static inline int commonPrefixLength(const uint32_t *a, const uint32_t *b, int maxLength) {
+    for (int i = 0; i * 32 < maxLength; i++) {
+        uint32_t diff = a[i] ^ b[i];
+        if (diff != 0) {
+            int length = i * 32 + __builtin_clz(diff);
+            return (length < maxLength) ? length : maxLength;
+        }
+    }
+
+    return maxLength;
+}
+
+/**
+ * Constructs path-compressed search trie.
+ * @param familyInfo Informations about addresses which will this trie accept.
+ */
+PatriciaTrieBase::PatriciaTrieBase(FamilyInfoBase *familyInfo)
+    : AddrLookupBase(familyInfo), rootNode(0), _nodeCount(0), _prefixCount(0), _uncompressedNodeCount(0)
+{
+    _bitLength = familyInfo->getAddrBitLength();
+    clear();
+}
+
+/**
+ * Destructor of the trie.
+ */
+PatriciaTrieBase::~PatriciaTrieBase()
+{
+    clearProtected(rootNode);
+}
+
+/**
+ * Inserts new ASN into trie.
+ * @param addr Address which should be inserted.
+ * @param prefix Defines how many bits should be stored into trie.
+ * @param asn Number of the autonomous system to be stored in destination node.
+ * @return True if no error occurs, else false.
+ */
+bool PatriciaTrieBase::insertASN(uint32_t *addr, int prefix, uint32_t asn) {
+    PatriciaNode *currNode = rootNode;
+    PatriciaNode *destNode = 0;
+
+    if ((prefix < 0) || (prefix > _bitLength) || (asn == NO_ASN)) {
+        return false;
+    }
+
+    /* Descends through the nodes whose prefixes are covering the inserted prefix */
+    while (currNode->length != prefix) {
+        PatriciaNode **link = &currNode->children[getBit(addr, currNode->length)];
+        PatriciaNode *childNode = *link;
+
+        if (childNode == 0) {         // There is no child, the rest of the prefix is single compressed edge
+            destNode = newNode(addr, prefix);
+            *link = destNode;
+            _uncompressedNodeCount += prefix - currNode->length;
+            break;
+        }
+
+        int common = commonPrefixLength(addr, childNode->key, (prefix < childNode->length) ? prefix : childNode->length);
+        if (common == childNode->length) { // Child covers the prefix, continue with it
+            currNode = childNode;
+            continue;
+        }
+
+        /* Prefix diverges from the edge to the child or ends on it, split the edge */
+        PatriciaNode *splitNode = newNode(addr, common);
+        splitNode->children[getBit(childNode->key, common)] = childNode;
+        *link = splitNode;
+
+        if (common == prefix) {        // Prefix ends on the edge, split node is the destination
+            destNode = splitNode;
+        } else {                       // Prefix diverges, new branch is created from the split node
+            destNode = newNode(addr, prefix);
+            splitNode->children[getBit(addr, common)] = destNode;
+            _uncompressedNodeCount += prefix - common;
+        }
+        break;
+    }
+
+    if (destNode == 0) {               // Prefix of the existing node is inserted
+        destNode = currNode;
+    }
+
+    if (destNode->value != NO_ASN) {   // Return fail whether destination node contains some value
+        return false;
+    }
+
+    destNode->value = asn;
+    _prefixCount++;
+
+    return true;
+}
+
+/**
+ * Allocates new node for the prefix of the address.
+ * @param addr Address whose prefix will be stored in node.
+ * @param length Length of the prefix.
+ * @return New node without value and children.
+ */
+PatriciaNode *PatriciaTrieBase::newNode(const uint32_t *addr, int length) {
+    PatriciaNode *node = new PatriciaNode();
+
+    for (int i = 0; i * 32 < length; i++) {  // Copy prefix bits, the rest of the key stays zero
+        int rest = length - i * 32;
+        node->key[i] = (rest >= 32) ? addr[i] : (addr[i] & ~(0xFFFFFFFF >> rest));
+    }
+    node->length = length;
+
+    _nodeCount++;
+    return node;
+}
+
+/**
+ * Clears all trie/removes from the memory.
+ */
+void PatriciaTrieBase::clear() {
+    clearProtected(rootNode);
+
+    rootNode = new PatriciaNode();  // Root with the prefix of the length 0 always exists
+    _nodeCount = 1;
+    _uncompressedNodeCount = 1;
+    _prefixCount = 0;
+}
+
+/**
+ * Fills statistics about the content and memory usage of the trie,
+ * uncompressed values describe bit trie with the same content.
+ * @param stats Structure which will be filled.
+ */
+void PatriciaTrieBase::getStats(LookupStats &stats) const {
+    stats.prefixes = _prefixCount;
+    stats.nodes = _nodeCount;
+    stats.bytes = _nodeCount * sizeof(PatriciaNode);
+    stats.uncompressedNodes = _uncompressedNodeCount;
+    stats.uncompressedBytes = _uncompressedNodeCount * sizeof(TrieNode);
+}
+
+/**
+ * Clears all nodes recursive from the specified node.
+ * @param node Node from which should be all other nodes removed.
+ */
+void PatriciaTrieBase::clearProtected(PatriciaNode *node) {
+    if (node != 0) {
+        clearProtected(node->children[0]);
+        clearProtected(node->children[1]);
+
+        delete node;
+    }
+}
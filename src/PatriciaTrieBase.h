@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       PatriciaTrieBase.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines path-compressed searching trie base class.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file PatriciaTrieBase.h
+ *
+ * @brief Defines path-compressed searching trie base class.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef PATRICIATRIEBASE_H
+#define PATRICIATRIEBASE_H
+
+#include "AddrLookupBase.h"
+
+/**
+ * Node of the path-compressed trie. Node keeps all bits of its prefix,
+ * so the skipped part of the edge from the parent is compared at once.
+ */
+struct PatriciaNode {
+    PatriciaNode *children[2];  /**< Left (0) and right (1) child */
+    uint32_t value;             /**< Value (ASN) of the prefix of this node, or 0 for branching only nodes */
+    uint32_t key[4];            /**< Bits of the prefix, bits behind the length are zero */
+    uint8_t length;             /**< Length of the prefix */
+};
+
+/**
+ * Class of the path-compressed (Patricia) searching trie. Chains of the nodes
+ * with single child and without value are skipped, so every node either
+ * holds value or branches into two children.
+ */
+class PatriciaTrieBase : public AddrLookupBase
+{
+public:
+    /**
+     * Constructs path-compressed search trie.
+     * @param familyInfo Informations about addresses which will this trie accept.
+     */
+    PatriciaTrieBase(FamilyInfoBase *familyInfo);
+
+    /**
+     * Destructor of the trie.
+     */
+    virtual ~PatriciaTrieBase();
+
+    using AddrLookupBase::insertASN;
+    using AddrLookupBase::longestPrefixMatch;
+
+    /**
+     * Inserts new ASN into trie.
+     * @param addr Address which should be inserted.
+     * @param prefix Defines how many bits should be stored into trie.
+     * @param asn Number of the autonomous system to be stored in destination node.
+     * @return True if no error occurs, else false.
+     */
+    virtual bool insertASN(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Searches address inside the trie and tries to find the corresponding ASN.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual inline uint32_t longestPrefixMatch(uint32_t *addr) {
+        PatriciaNode *currNode = rootNode;
+        uint32_t ret_value = rootNode->value;
+
+        /* Descends while the whole prefix of the child matches the address */
+        while (currNode->length < _bitLength) {
+            currNode = currNode->children[getBit(addr, currNode->length)];
+
+            if ((currNode == 0) || !matchesPrefix(addr, currNode->key, currNode->length)) {
+                break;
+            }
+
+            if (currNode->value != NO_ASN) { // Currently longest corresponding ASN, try to find a better one
+                ret_value = currNode->value;
+            }
+        }
+
+        return ret_value;
+    }
+
+    /**
+     * Clears all trie/removes from the memory.
+     */
+    virtual void clear();
+
+    /**
+     * Fills statistics about the content and memory usage of the trie,
+     * uncompressed values describe bit trie with the same content.
+     * @param stats Structure which will be filled.
+     */
+    virtual void getStats(LookupStats &stats) const;
+
+protected:
+    PatriciaNode *rootNode;          /**< Root node of the trie (prefix of the length 0) */
+
+    /**
+     * Tests whether address starts with the prefix.
+     * @param addr Tested address.
+     * @param key Bits of the prefix.
+     * @param length Length of the prefix.
+     * @return True if address starts with the prefix, else false.
+     */
+    static inline bool matchesPrefix(const uint32_t *addr, const uint32_t *key, int length) {
+        int words = length >> 5;
+        for (int i = 0; i < words; i++) {
+            if (addr[i] != key[i]) {
+                return false;
+            }
+        }
+
+        int rest = length & 31;
+        return (rest == 0) || (((addr[words] ^ key[words]) >> (32 - rest)) == 0);
+    }
+
+    /**
+     * Allocates new node for the prefix of the address.
+     * @param addr Address whose prefix will be stored in node.
+     * @param length Length of the prefix.
+     * @return New node without value and children.
+     */
+    PatriciaNode *newNode(const uint32_t *addr, int length);
+
+    /**
+     * Clears all nodes recursive from the specified node.
+     * @param node Node from which should be all other nodes removed.
+     */
+    void clearProtected(PatriciaNode *node);
+
+private:
+    int _bitLength;                  /**< Length of the address in bits */
+    size_t _nodeCount;               /**< Number of the allocated nodes */
+    size_t _prefixCount;             /**< Number of the stored prefixes */
+    size_t _uncompressedNodeCount;   /**< Number of the nodes of the equivalent bit trie */
+};
+
+#endif // PATRICIATRIEBASE_H
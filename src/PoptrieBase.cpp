@@ -0,0 +1,323 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       PoptrieBase.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing compressed bitmap trie (Poptrie).
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file PoptrieBase.cpp
+ *
+ * @brief Implements compressed bitmap trie (Poptrie).
+ * @author Longest-Prefix Match contributors
+ */
+
+#include "PoptrieBase.h"
+
+const int PoptrieBase::DIRECT_BITS;
+const int PoptrieBase::STRIDE;
+const uint32_t PoptrieBase::DIRECT_NODE;
+
+/**
+ * Constructs empty Poptrie.
+ * @param familyInfo Informations about addresses which will this trie accept.
+ */
+PoptrieBase::PoptrieBase(FamilyInfoBase *familyInfo)
+    : AddrTrieBase(familyInfo), _direct(1 << DIRECT_BITS, 0), _hasPopcnt(false)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    _hasPopcnt = __builtin_cpu_supports("popcnt");
+#endif
+}
+
+/**
+ * Destructor of the trie.
+ */
+PoptrieBase::~PoptrieBase()
+{
+}
+
+/**
+ * Compiles Poptrie from the inserted prefixes. Top level is expanded from
+ * the bit trie directly, every its subtree with longer prefixes becomes
+ * internal node which is compiled recursively.
+ */
+void PoptrieBase::build() {
+    const TrieNode *nodes = _nodes.getNodes();
+    vector<Subtree> subtrees(1 << DIRECT_BITS);
+
+    _asns.clear();
+    _pnodes.clear();
+    _leaves.clear();
+
+    uint32_t rootValue = nodes[ROOT_NODE].getValue();
+    expand(nodes, ROOT_NODE, 0, DIRECT_BITS, 0, (rootValue != NO_ASN) ? _asns.intern(rootValue) : 0, &subtrees[0]);
+
+    for (size_t i = 0; i < subtrees.size(); i++) {
+        if (subtrees[i].node == ROOT_NODE) {
+            _direct[i] = subtrees[i].value;
+        } else {
+            uint32_t index = _pnodes.size();
+            _pnodes.resize(index + 1);
+            compileNode(nodes, index, subtrees[i]);
+            _direct[i] = DIRECT_NODE | index;
+        }
+    }
+}
+
+/**
+ * Expands subtrie of the bit trie into subtrees of the fixed depth.
+ * Missing child turns all subtrees under it into leaves.
+ * @param nodes Nodes of the bit trie.
+ * @param node Expanded node.
+ * @param depth Depth of the node inside the expanded subtrie.
+ * @param levels Depth of the subtrees.
+ * @param index Index of the node inside its level.
+ * @param value Index of the ASN of the longest prefix covering the node.
+ * @param subtrees Array of the 2^levels subtrees which will be filled.
+ */
+void PoptrieBase::expand(const TrieNode *nodes, uint32_t node, int depth, int levels, uint32_t index,
+                         uint32_t value, Subtree *subtrees) {
+    if (depth == levels) {
+        bool inner = (nodes[node].getLeftChild() != ROOT_NODE) || (nodes[node].getRightChild() != ROOT_NODE);
+        subtrees[index].node = inner ? node : ROOT_NODE;
+        subtrees[index].value = value;
+        return;
+    }
+
+    for (int bit = 0; bit < 2; bit++) {
+        uint32_t child = nodes[node].getChild(bit);
+        uint32_t childIndex = (index << 1) | bit;
+
+        if (child == ROOT_NODE) {       // The same leaf for all subtrees under the child
+            int shift = levels - depth - 1;
+            for (uint32_t i = childIndex << shift; i < ((childIndex + 1) << shift); i++) {
+                subtrees[i].node = ROOT_NODE;
+                subtrees[i].value = value;
+            }
+        } else {
+            uint32_t childValue = nodes[child].getValue();
+            expand(nodes, child, depth + 1, levels, childIndex,
+                   (childValue != NO_ASN) ? _asns.intern(childValue) : value, subtrees);
+        }
+    }
+}
+
+/**
+ * Compiles internal node and all its descendants. Children of the node are
+ * allocated at once behind the current nodes, so they stay together.
+ * @param nodes Nodes of the bit trie.
+ * @param index Index of the compiled node, it has to be allocated.
+ * @param subtree Subtree of the node.
+ */
+void PoptrieBase::compileNode(const TrieNode *nodes, uint32_t index, const Subtree &subtree) {
+    Subtree subtrees[1 << STRIDE];
+    expand(nodes, subtree.node, 0, STRIDE, 0, subtree.value, subtrees);
+
+    PoptrieNode node = {0, 0, (uint32_t)_leaves.size(), (uint32_t)_pnodes.size()};
+    size_t childCount = 0;
+    bool lastLeaf = false;
+
+    for (int i = 0; i < (1 << STRIDE); i++) {
+        if (subtrees[i].node != ROOT_NODE) {
+            node.children |= (uint64_t)1 << i;
+            childCount++;
+        } else if (!lastLeaf || (_leaves.back() != subtrees[i].value)) {  // New run of the leaves
+            node.leaves |= (uint64_t)1 << i;
+            _leaves.push_back(subtrees[i].value);
+            lastLeaf = true;
+        }
+    }
+
+    _pnodes[index] = node;
+    _pnodes.resize(node.childBase + childCount);
+
+    uint32_t child = node.childBase;
+    for (int i = 0; i < (1 << STRIDE); i++) {
+        if (subtrees[i].node != ROOT_NODE) {
+            compileNode(nodes, child++, subtrees[i]);
+        }
+    }
+}
+
+/**
+ * Compiled table cannot be updated incrementally.
+ * @param addr Address of the prefix (unused).
+ * @param prefix Length of the prefix (unused).
+ * @param asn Number of the autonomous system (unused).
+ * @return Always false.
+ */
+bool PoptrieBase::update(uint32_t *addr, int prefix, uint32_t asn) {
+    return AddrLookupBase::update(addr, prefix, asn);
+}
+
+/**
+ * Compiled table cannot be updated incrementally.
+ * @param addr Address of the prefix (unused).
+ * @param prefix Length of the prefix (unused).
+ * @return Always false.
+ */
+bool PoptrieBase::withdraw(uint32_t *addr, int prefix) {
+    return AddrLookupBase::withdraw(addr, prefix);
+}
+
+/**
+ * Searches address inside the trie and tries to find the corresponding ASN.
+ * Searching uses popcnt instruction if the processor has it.
+ * @param addr Address which should be searched.
+ * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+ */
+uint32_t PoptrieBase::longestPrefixMatch(uint32_t *addr) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (_hasPopcnt) {
+        return searchPopcnt(addr);
+    }
+#endif
+    return search(addr);
+}
+
+/**
+ * Searches more addresses at once. Walks advance in lockstep, each round
+ * prefetches the next nodes of all walks before they are read.
+ * Searching uses popcnt instruction if the processor has it.
+ * @param addrs Addresses which should be searched, each has getAddrWords() words.
+ * @param n Number of the addresses.
+ * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+ */
+void PoptrieBase::longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (_hasPopcnt) {
+        searchBatchPopcnt(addrs, n, out);
+        return;
+    }
+#endif
+    searchBatch(addrs, n, out);
+}
+
+/**
+ * Searches address inside the compiled trie. Index of the searched subtree
+ * among the children or the leaves of the node is the number of the bits
+ * of the bitmap up to the subtree.
+ * @param addr Address which should be searched.
+ * @return Found number of the autonomous system, or NO_ASN if no address matched.
+ */
+inline uint32_t PoptrieBase::search(const uint32_t *addr) const {
+    int words = getAddrWords();
+    uint32_t entry = _direct[extractBits(addr, words, 0, DIRECT_BITS)];
+
+    if (!(entry & DIRECT_NODE)) {            // Leaf of the top level
+        return _asns.getASN(entry);
+    }
+
+    const PoptrieNode *node = &_pnodes[entry & ~DIRECT_NODE];
+    for (int pos = DIRECT_BITS;; pos += STRIDE) {
+        uint32_t index = extractBits(addr, words, pos, STRIDE);
+        uint64_t upTo = ((uint64_t)2 << index) - 1;    // Subtrees up to the searched one
+
+        if (!((node->children >> index) & 1)) {         // Searched subtree is leaf
+            return _asns.getASN(_leaves[node->leafBase + __builtin_popcountll(node->leaves & upTo) - 1]);
+        }
+        node = &_pnodes[node->childBase + __builtin_popcountll(node->children & upTo) - 1];
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * Searches address, popcount is compiled into popcnt instruction.
+ * @param addr Address which should be searched.
+ * @return Found number of the autonomous system, or NO_ASN if no address matched.
+ */
+uint32_t PoptrieBase::searchPopcnt(const uint32_t *addr) const {
+    return search(addr);
+}
+
+/**
+ * Searches more addresses, popcount is compiled into popcnt instruction.
+ * @param addrs Addresses which should be searched, each has getAddrWords() words.
+ * @param n Number of the addresses.
+ * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+ */
+void PoptrieBase::searchBatchPopcnt(const uint32_t *addrs, size_t n, uint32_t *out) const {
+    searchBatch(addrs, n, out);
+}
+#endif
+
+/**
+ * Searches more addresses in the compiled trie, walks advance in lockstep.
+ * @param addrs Addresses which should be searched, each has getAddrWords() words.
+ * @param n Number of the addresses.
+ * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+ */
+inline void PoptrieBase::searchBatch(const uint32_t *addrs, size_t n, uint32_t *out) const {
+    int words = getAddrWords();
+    uint32_t currNodes[BATCH_WAYS];     // DIRECT_NODE marks finished walk
+
+    for (size_t base = 0; base < n; base += BATCH_WAYS) {
+        size_t ways = (n - base < BATCH_WAYS) ? n - base : BATCH_WAYS;
+        const uint32_t *addr = &addrs[base * words];
+        size_t active = 0;
+
+        for (size_t w = 0; w < ways; w++) {
+            uint32_t entry = _direct[extractBits(&addr[w * words], words, 0, DIRECT_BITS)];
+            if (entry & DIRECT_NODE) {
+                currNodes[w] = entry & ~DIRECT_NODE;
+                __builtin_prefetch(&_pnodes[currNodes[w]]);
+                active++;
+            } else {
+                currNodes[w] = DIRECT_NODE;
+                out[base + w] = _asns.getASN(entry);
+            }
+        }
+
+        /* Every round reads prefetched node of each walk and prefetches its child */
+        for (int pos = DIRECT_BITS; active > 0; pos += STRIDE) {
+            for (size_t w = 0; w < ways; w++) {
+                if (currNodes[w] == DIRECT_NODE) {
+                    continue;
+                }
+
+                const PoptrieNode &node = _pnodes[currNodes[w]];
+                uint32_t index = extractBits(&addr[w * words], words, pos, STRIDE);
+                uint64_t upTo = ((uint64_t)2 << index) - 1;
+
+                if ((node.children >> index) & 1) {
+                    currNodes[w] = node.childBase + __builtin_popcountll(node.children & upTo) - 1;
+                    __builtin_prefetch(&_pnodes[currNodes[w]]);
+                } else {
+                    out[base + w] = _asns.getASN(_leaves[node.leafBase + __builtin_popcountll(node.leaves & upTo) - 1]);
+                    currNodes[w] = DIRECT_NODE;
+                    active--;
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Clears all trie/removes from the memory.
+ */
+void PoptrieBase::clear() {
+    AddrTrieBase::clear();
+    _direct.assign(1 << DIRECT_BITS, 0);
+    _pnodes.clear();
+    _leaves.clear();
+    _asns.clear();
+}
+
+/**
+ * Fills statistics about the content and memory usage of the trie.
+ * @param stats Structure which will be filled, nodes are the internal nodes,
+ *              uncompressed nodes and memory are of the source bit trie.
+ */
+void PoptrieBase::getStats(LookupStats &stats) const {
+    AddrTrieBase::getStats(stats);
+    stats.uncompressedNodes = stats.nodes;
+    stats.uncompressedBytes = stats.nodes * sizeof(TrieNode);  // Used nodes of the bit trie, not capacity of its pool
+    stats.nodes = _pnodes.size();
+    stats.bytes = _direct.size() * sizeof(uint32_t) + _pnodes.size() * sizeof(PoptrieNode)
+                  + _leaves.size() * sizeof(uint32_t) + _asns.size() * sizeof(uint32_t);
+}
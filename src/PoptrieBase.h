@@ -0,0 +1,198 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       PoptrieBase.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines compressed bitmap trie (Poptrie).
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file PoptrieBase.h
+ *
+ * @brief Defines compressed bitmap trie (Poptrie).
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef POPTRIEBASE_H
+#define POPTRIEBASE_H
+
+#include <vector>
+
+#include "AddrTrieBase.h"
+#include "AsnTable.h"
+
+using namespace std;
+
+/**
+ * Internal node of the Poptrie, it covers STRIDE bits of the address.
+ * Children of the node are stored one after another, so are its leaves.
+ */
+struct PoptrieNode {
+    uint64_t children;          /**< Bit i is set if the i-th subtree is internal node */
+    uint64_t leaves;            /**< Bit i is set if the i-th subtree starts new run of the equal leaves */
+    uint32_t leafBase;          /**< Index of the first leaf of the node */
+    uint32_t childBase;         /**< Index of the first child of the node */
+};
+
+/**
+ * Compressed bitmap trie (Poptrie, Asai and Ohara). Internal nodes have 64
+ * subtrees, bitmaps of the node tell which of them are internal nodes and
+ * where the runs of the equal leaves start, so the index into the arrays of
+ * the children and the leaves is counted by popcount. Upper DIRECT_BITS of
+ * the address index the top level directly. Nodes have 24 bytes and leaves
+ * 4 bytes, so the whole table fits into the caches much better than the bit trie.
+ *
+ * Prefixes are inserted into the inherited bit trie which stays as the source
+ * of the table, build() compiles the Poptrie from it. Lookups search only the
+ * compiled table, prefixes inserted later are searchable after next build().
+ */
+class PoptrieBase : public AddrTrieBase
+{
+public:
+    /**
+     * Constructs empty Poptrie.
+     * @param familyInfo Informations about addresses which will this trie accept.
+     */
+    PoptrieBase(FamilyInfoBase *familyInfo);
+
+    /**
+     * Destructor of the trie.
+     */
+    virtual ~PoptrieBase();
+
+    using AddrTrieBase::insertASN;
+    using AddrTrieBase::longestPrefixMatch;
+
+    /**
+     * Compiles Poptrie from the inserted prefixes.
+     */
+    virtual void build();
+
+    /**
+     * Compiled table cannot be updated incrementally.
+     * @param addr Address of the prefix (unused).
+     * @param prefix Length of the prefix (unused).
+     * @param asn Number of the autonomous system (unused).
+     * @return Always false.
+     */
+    virtual bool update(uint32_t *addr, int prefix, uint32_t asn);
+
+    /**
+     * Compiled table cannot be updated incrementally.
+     * @param addr Address of the prefix (unused).
+     * @param prefix Length of the prefix (unused).
+     * @return Always false.
+     */
+    virtual bool withdraw(uint32_t *addr, int prefix);
+
+    /**
+     * Searches address inside the trie and tries to find the corresponding ASN.
+     * Searching uses popcnt instruction if the processor has it.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system on successful searching, or NO_ASN if no address matched.
+     */
+    virtual uint32_t longestPrefixMatch(uint32_t *addr);
+
+    /**
+     * Searches more addresses at once. Walks advance in lockstep, each round
+     * prefetches the next nodes of all walks before they are read.
+     * Searching uses popcnt instruction if the processor has it.
+     * @param addrs Addresses which should be searched, each has getAddrWords() words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    virtual void longestPrefixMatchBatch(const uint32_t *addrs, size_t n, uint32_t *out);
+
+    /**
+     * Clears all trie/removes from the memory.
+     */
+    virtual void clear();
+
+    /**
+     * Fills statistics about the content and memory usage of the trie.
+     * @param stats Structure which will be filled, nodes are the internal nodes,
+     *              uncompressed nodes and memory are of the source bit trie.
+     */
+    virtual void getStats(LookupStats &stats) const;
+
+    const static int DIRECT_BITS = 18;          /**< Address bits indexing the top level */
+    const static int STRIDE = 6;                /**< Address bits covered by the internal node */
+    const static uint32_t DIRECT_NODE = 0x80000000; /**< Top level entry is index of the internal node */
+
+private:
+    /**
+     * Subtree of the expanded node.
+     */
+    struct Subtree {
+        uint32_t node;          /**< Node of the bit trie with longer prefixes, or ROOT_NODE for leaf */
+        uint32_t value;         /**< Index of the ASN of the longest prefix covering the subtree */
+    };
+
+    vector<uint32_t> _direct;       /**< Top level, index of the ASN or DIRECT_NODE and index of the node */
+    vector<PoptrieNode> _pnodes;    /**< Internal nodes */
+    vector<uint32_t> _leaves;       /**< Leaves, indices of the ASNs */
+    AsnTable _asns;                 /**< ASNs referenced by the leaves */
+    bool _hasPopcnt;                /**< Processor has popcnt instruction (x86 only) */
+
+    /**
+     * Searches address inside the compiled trie.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system, or NO_ASN if no address matched.
+     */
+    inline uint32_t search(const uint32_t *addr) const;
+
+#if defined(__x86_64__) || defined(__i386__)
+    /**
+     * Searches address, popcount is compiled into popcnt instruction.
+     * @param addr Address which should be searched.
+     * @return Found number of the autonomous system, or NO_ASN if no address matched.
+     */
+    uint32_t searchPopcnt(const uint32_t *addr) const __attribute__((target("popcnt")));
+#endif
+
+    /**
+     * Searches more addresses in the compiled trie.
+     * @param addrs Addresses which should be searched, each has getAddrWords() words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    inline void searchBatch(const uint32_t *addrs, size_t n, uint32_t *out) const;
+
+#if defined(__x86_64__) || defined(__i386__)
+    /**
+     * Searches more addresses, popcount is compiled into popcnt instruction.
+     * @param addrs Addresses which should be searched, each has getAddrWords() words.
+     * @param n Number of the addresses.
+     * @param out Array where found numbers of the autonomous systems (or NO_ASN) will be stored.
+     */
+    void searchBatchPopcnt(const uint32_t *addrs, size_t n, uint32_t *out) const __attribute__((target("popcnt")));
+#endif
+
+    /**
+     * Expands subtrie of the bit trie into subtrees of the fixed depth.
+     * @param nodes Nodes of the bit trie.
+     * @param node Expanded node.
+     * @param depth Depth of the node inside the expanded subtrie.
+     * @param levels Depth of the subtrees.
+     * @param index Index of the node inside its level.
+     * @param value Index of the ASN of the longest prefix covering the node.
+     * @param subtrees Array of the 2^levels subtrees which will be filled.
+     */
+    void expand(const TrieNode *nodes, uint32_t node, int depth, int levels, uint32_t index,
+                uint32_t value, Subtree *subtrees);
+
+    /**
+     * Compiles internal node and all its descendants.
+     * @param nodes Nodes of the bit trie.
+     * @param index Index of the compiled node, it has to be allocated.
+     * @param subtree Subtree of the node.
+     */
+    void compileNode(const TrieNode *nodes, uint32_t index, const Subtree &subtree);
+
+    PoptrieBase(const PoptrieBase &);
+    PoptrieBase &operator=(const PoptrieBase &);
+};
+
+#endif // POPTRIEBASE_H
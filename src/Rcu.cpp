@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       Rcu.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing epoch based read-copy-update.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file Rcu.cpp
+ *
+ * @brief Implements epoch based read-copy-update.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <unistd.h>
+
+#include "Rcu.h"
+
+/**
+ * Interval of polling the readers by synchronize() in microseconds.
+ */
+const static useconds_t SYNCHRONIZE_POLL = 1000;
+
+/**
+ * Constructs domain without readers.
+ */
+RcuDomain::RcuDomain() : _epoch(1), _readers(NULL)
+{
+    pthread_mutex_init(&_mutex, NULL);
+}
+
+/**
+ * Destructor, frees all readers.
+ */
+RcuDomain::~RcuDomain()
+{
+    while (_readers != NULL) {
+        RcuReader *reader = _readers;
+        _readers = reader->next;
+        delete reader;
+    }
+
+    pthread_mutex_destroy(&_mutex);
+}
+
+/**
+ * Registers reader of the calling thread.
+ * @return Reader which is passed into readLock() and readUnlock().
+ */
+RcuReader *RcuDomain::registerReader() {
+    pthread_mutex_lock(&_mutex);
+
+    RcuReader *reader = _readers;
+    while ((reader != NULL) && reader->used) {
+        reader = reader->next;
+    }
+
+    if (reader == NULL) {       // No free reader, new one is put at the head of the list
+        reader = new RcuReader();
+        reader->epoch = 0;
+        reader->next = _readers;
+        __atomic_store_n(&_readers, reader, __ATOMIC_RELEASE);  // Reader is initialized before synchronize() can reach it
+    }
+    reader->used = true;
+
+    pthread_mutex_unlock(&_mutex);
+    return reader;
+}
+
+/**
+ * Unregisters reader, reader must not be in critical section.
+ * @param reader Reader which should be unregistered.
+ */
+void RcuDomain::unregisterReader(RcuReader *reader) {
+    pthread_mutex_lock(&_mutex);
+    reader->used = false;
+    pthread_mutex_unlock(&_mutex);
+}
+
+/**
+ * Tests whether all readers which entered critical section before the epoch have left it.
+ * @param epoch Epoch returned by advance().
+ * @return True if data unpublished before the epoch can be freed, else false.
+ */
+bool RcuDomain::passed(uint64_t epoch) const {
+    /* Readers which announce the new epoch already see the new data */
+    for (RcuReader *reader = __atomic_load_n(&_readers, __ATOMIC_ACQUIRE); reader != NULL; reader = reader->next) {
+        uint64_t readerEpoch = __atomic_load_n(&reader->epoch, __ATOMIC_SEQ_CST);
+        if ((readerEpoch != 0) && (readerEpoch < epoch)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Waits until all readers which entered critical section before the call have left it.
+ */
+void RcuDomain::synchronize() {
+    uint64_t epoch = advance();
+
+    while (!passed(epoch)) {
+        usleep(SYNCHRONIZE_POLL);
+    }
+}
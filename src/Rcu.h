@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       Rcu.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines epoch based read-copy-update.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file Rcu.h
+ *
+ * @brief Defines epoch based read-copy-update.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef RCU_H
+#define RCU_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+
+/**
+ * Reader registered in the RCU domain. Every reader is used by one thread
+ * and lies on its own cache line, so readers do not share written lines.
+ */
+struct RcuReader {
+    uint64_t epoch;             /**< Epoch announced in critical section, 0 outside of it */
+    RcuReader *next;            /**< Next reader of the domain */
+    bool used;                  /**< Reader is registered by some thread */
+    char padding[64];           /**< Keeps readers on different cache lines */
+};
+
+/**
+ * Epoch based read-copy-update domain. Readers announce current epoch when
+ * they enter critical section, which costs one sequentially consistent store,
+ * they never wait. Writer publishes new data, advances the epoch and waits
+ * until every reader which could have seen the old data has left its critical
+ * section, the old data can be freed afterwards.
+ */
+class RcuDomain
+{
+public:
+    /**
+     * Constructs domain without readers.
+     */
+    RcuDomain();
+
+    /**
+     * Destructor, frees all readers.
+     */
+    ~RcuDomain();
+
+    /**
+     * Registers reader of the calling thread.
+     * @return Reader which is passed into readLock() and readUnlock().
+     */
+    RcuReader *registerReader();
+
+    /**
+     * Unregisters reader, reader must not be in critical section.
+     * @param reader Reader which should be unregistered.
+     */
+    void unregisterReader(RcuReader *reader);
+
+    /**
+     * Enters critical section, data published by RcuPointer can be read until readUnlock().
+     * @param reader Reader of the calling thread.
+     */
+    inline void readLock(RcuReader *reader) {
+        // Announce has to be visible before the pointers are read, seq_cst store alone may be reordered with later loads
+        __atomic_store_n(&reader->epoch, __atomic_load_n(&_epoch, __ATOMIC_RELAXED), __ATOMIC_SEQ_CST);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    }
+
+    /**
+     * Leaves critical section.
+     * @param reader Reader of the calling thread.
+     */
+    inline void readUnlock(RcuReader *reader) {
+        __atomic_store_n(&reader->epoch, 0, __ATOMIC_RELEASE);
+    }
+
+    /**
+     * Advances the epoch, data unpublished before the call are not reachable by readers which announce the new epoch.
+     * @return New epoch.
+     */
+    inline uint64_t advance() {
+        return __atomic_add_fetch(&_epoch, 1, __ATOMIC_SEQ_CST);
+    }
+
+    /**
+     * Tests whether all readers which entered critical section before the epoch have left it.
+     * @param epoch Epoch returned by advance().
+     * @return True if data unpublished before the epoch can be freed, else false.
+     */
+    bool passed(uint64_t epoch) const;
+
+    /**
+     * Waits until all readers which entered critical section before the call have left it.
+     */
+    void synchronize();
+
+private:
+    uint64_t _epoch;            /**< Current epoch, starts at 1 */
+    RcuReader *_readers;        /**< List of the readers, readers are reused but never removed */
+    pthread_mutex_t _mutex;     /**< Guards registration of the readers */
+
+    RcuDomain(const RcuDomain &);
+    RcuDomain &operator=(const RcuDomain &);
+};
+
+/**
+ * Pointer to the data which are read under RcuDomain critical section and
+ * replaced by single writer.
+ */
+template<class T>
+class RcuPointer
+{
+public:
+    /**
+     * Constructs pointer.
+     * @param ptr Initial data.
+     */
+    RcuPointer(T *ptr = NULL) : _ptr(ptr) {}
+
+    /**
+     * Gets current data, has to be called inside of critical section.
+     * @return Current data.
+     */
+    inline T *get() const {
+        return __atomic_load_n(&_ptr, __ATOMIC_SEQ_CST);
+    }
+
+    /**
+     * Publishes new data. Old data can be freed after RcuDomain::synchronize().
+     * @param ptr New completely built data.
+     * @return Old data.
+     */
+    inline T *exchange(T *ptr) {
+        return __atomic_exchange_n(&_ptr, ptr, __ATOMIC_SEQ_CST);
+    }
+
+private:
+    T *_ptr;                    /**< Current data */
+
+    RcuPointer(const RcuPointer &);
+    RcuPointer &operator=(const RcuPointer &);
+};
+
+#endif // RCU_H
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       RouteUpdater.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing updater of the live tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file RouteUpdater.cpp
+ *
+ * @brief Implements updater of the live tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "LineSearcher.h"
+#include "RouteUpdater.h"
+
+const size_t RouteUpdater::BUFFER_SIZE;
+const int RouteUpdater::POLL_TIMEOUT;
+
+/**
+ * Constructs updater of the tables, updating is started by start().
+ * @param tables Holder of the updated tables.
+ */
+RouteUpdater::RouteUpdater(TableReloader &tables)
+    : _tables(tables), _fd(-1), _running(false), _stopping(false), _applied(0)
+{
+}
+
+/**
+ * Destructor, stops updating.
+ */
+RouteUpdater::~RouteUpdater()
+{
+    stop();
+}
+
+/**
+ * Opens the file with updates and starts updater thread.
+ * @param filename File with update lines.
+ * @return True if the thread has been started, else false.
+ */
+bool RouteUpdater::start(const string &filename) {
+    _fd = open(filename.c_str(), O_RDONLY);   // Pipe blocks until its writer connects
+    if (_fd == -1) {
+        return false;
+    }
+
+    _stopping = false;
+    _running = (pthread_create(&_thread, NULL, updaterThread, this) == 0);
+    if (!_running) {
+        close(_fd);
+        _fd = -1;
+    }
+
+    return _running;
+}
+
+/**
+ * Stops updater thread, updates which have not been read yet are skipped.
+ */
+void RouteUpdater::stop() {
+    if (!_running) {
+        return;
+    }
+
+    __atomic_store_n(&_stopping, true, __ATOMIC_RELEASE);
+    pthread_join(_thread, NULL);
+    _running = false;
+
+    close(_fd);
+    _fd = -1;
+}
+
+/**
+ * Entry point of the updater thread.
+ * @param updater Updater which runs the thread.
+ * @return Always NULL.
+ */
+void *RouteUpdater::updaterThread(void *updater) {
+    static_cast<RouteUpdater *>(updater)->run();
+    return NULL;
+}
+
+/**
+ * Reads update lines until the end of the file or stop() and applies them.
+ */
+void RouteUpdater::run() {
+    char *buffer = new char[BUFFER_SIZE + 1];
+    size_t head = 0;
+    RcuReader *reader = _tables.registerReader();
+
+    while (!__atomic_load_n(&_stopping, __ATOMIC_ACQUIRE)) {
+        struct pollfd input;
+        input.fd = _fd;
+        input.events = POLLIN;
+        if (poll(&input, 1, POLL_TIMEOUT) <= 0) {  // Stop flag is checked at least every timeout
+            continue;
+        }
+
+        ssize_t read_bytes = read(_fd, &buffer[head], BUFFER_SIZE - head);
+        if (read_bytes <= 0) {
+            break;
+        }
+        char *end = &buffer[head + read_bytes];
+        *end = '\0';
+
+        /* Updater reads the tables as well, so they are not freed by reload meanwhile */
+        const TableSet *tables = _tables.readLock(reader);
+        char *lineChars = buffer;
+        char *lineEnd;
+        while ((lineEnd = static_cast<char *>(memchr(lineChars, '\n', end - lineChars))) != NULL) {
+            *lineEnd = '\0';
+
+            if ((*lineChars == '+') || (*lineChars == '-')) {
+                AddrLookupBase &trie = (strchr(lineChars, ':') != NULL) ? *tables->ipv6 : *tables->ipv4;
+                if (LineSearcher::applyUpdate(trie, lineChars)) {
+                    __atomic_add_fetch(&_applied, 1, __ATOMIC_RELAXED);
+                }
+            }
+
+            lineChars = lineEnd + 1;
+        }
+        _tables.readUnlock(reader);
+        _tables.markUpdated();      // Searchers drop results cached before the updates
+
+        // Incomplete last line is moved to the beginning, line longer than the buffer is skipped
+        head = end - lineChars;
+        if (head == BUFFER_SIZE) {
+            head = 0;
+        }
+        memmove(buffer, lineChars, head);
+    }
+
+    _tables.unregisterReader(reader);
+    delete[] buffer;
+}
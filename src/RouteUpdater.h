@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       RouteUpdater.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines updater of the live tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file RouteUpdater.h
+ *
+ * @brief Defines updater of the live tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef ROUTEUPDATER_H
+#define ROUTEUPDATER_H
+
+#include <pthread.h>
+
+#include <string>
+
+#include "TableReloader.h"
+
+using namespace std;
+
+/**
+ * Thread which reads update lines "+prefix asn" and "-prefix" from the file
+ * (e.g. pipe fed by BGP session) and applies them to the current tables while
+ * the searching threads keep reading them. Updater is the only writer of the
+ * tables, tables have to use reclaim domain of the reloader.
+ */
+class RouteUpdater
+{
+public:
+    /**
+     * Constructs updater of the tables, updating is started by start().
+     * @param tables Holder of the updated tables.
+     */
+    RouteUpdater(TableReloader &tables);
+
+    /**
+     * Destructor, stops updating.
+     */
+    ~RouteUpdater();
+
+    /**
+     * Opens the file with updates and starts updater thread.
+     * @param filename File with update lines.
+     * @return True if the thread has been started, else false.
+     */
+    bool start(const string &filename);
+
+    /**
+     * Stops updater thread, updates which have not been read yet are skipped.
+     */
+    void stop();
+
+    /**
+     * Returns number of the applied update lines.
+     * @return Number of the applied update lines.
+     */
+    inline size_t getApplied() const {
+        return __atomic_load_n(&_applied, __ATOMIC_RELAXED);
+    }
+
+    const static size_t BUFFER_SIZE = 65536;  /**< Size of the read buffer */
+    const static int POLL_TIMEOUT = 100;      /**< Timeout of waiting for updates in milliseconds */
+
+private:
+    TableReloader &_tables;     /**< Holder of the updated tables */
+    int _fd;                    /**< File with update lines */
+    pthread_t _thread;          /**< Updater thread */
+    bool _running;              /**< Updater thread has been started */
+    bool _stopping;             /**< Updater thread should finish, accessed atomically */
+    size_t _applied;            /**< Number of the applied update lines, accessed atomically */
+
+    /**
+     * Entry point of the updater thread.
+     * @param updater Updater which runs the thread.
+     * @return Always NULL.
+     */
+    static void *updaterThread(void *updater);
+
+    /**
+     * Reads update lines until the end of the file or stop() and applies them.
+     */
+    void run();
+
+    RouteUpdater(const RouteUpdater &);
+    RouteUpdater &operator=(const RouteUpdater &);
+};
+
+#endif // ROUTEUPDATER_H
@@ -0,0 +1,162 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       RuntimeStats.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing counters of the running lookups.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file RuntimeStats.cpp
+ *
+ * @brief Implements counters of the running lookups.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "AddrTrieBase.h"
+#include "RuntimeStats.h"
+
+__thread StatsCounters RuntimeStats::_local;
+StatsCounters RuntimeStats::_total;
+pthread_mutex_t RuntimeStats::_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Names of the phases in the report, searching is reported without lookups
+ * and formatting as parsing of the lines.
+ */
+static const char *PHASE_NAMES[RuntimeStats::PHASES] = {"load", "read", "parse", "lookup", "format", "write"};
+
+/**
+ * Names of the families in the report.
+ */
+static const char *FAMILY_NAMES[2] = {"ipv4", "ipv6"};
+
+/**
+ * Adds counters of the calling thread into totals and clears them.
+ */
+void RuntimeStats::merge() {
+    const uint64_t *from = reinterpret_cast<const uint64_t *>(&_local);
+    uint64_t *to = reinterpret_cast<uint64_t *>(&_total);
+
+    pthread_mutex_lock(&_mutex);
+    for (size_t i = 0; i < sizeof(StatsCounters) / sizeof(uint64_t); i++) {
+        to[i] += from[i];
+    }
+    pthread_mutex_unlock(&_mutex);
+
+    memset(&_local, 0, sizeof(_local));
+}
+
+/**
+ * Prints counters and shape of the tables as JSON document. Counters are
+ * printed only if they are compiled in, shape of the tables always.
+ * @param out Stream where the report is printed.
+ * @param ipv4Table Searched IPv4 table.
+ * @param ipv6Table Searched IPv6 table.
+ * @param ipv4Engine Name of the IPv4 engine.
+ * @param ipv6Engine Name of the IPv6 engine.
+ */
+void RuntimeStats::printReport(ostream &out, const AddrLookupBase &ipv4Table, const AddrLookupBase &ipv6Table,
+                               const string &ipv4Engine, const string &ipv6Engine) {
+    pthread_mutex_lock(&_mutex);
+
+    out << "{\n  \"instrumented\": " << (isEnabled() ? "true" : "false");
+    if (isEnabled()) {
+        uint64_t phases[PHASES];
+        memcpy(phases, _total.cycles, sizeof(phases));
+        phases[PHASE_SEARCH] -= phases[PHASE_LOOKUP] + phases[PHASE_FORMAT];
+
+        out << ",\n  \"lines\": " << _total.lines
+            << ",\n  \"matched\": " << _total.matchedLines
+            << ",\n  \"unmatched\": " << _total.lines - _total.matchedLines
+            << ",\n  \"cycles\": {";
+        for (int phase = 0; phase < PHASES; phase++) {
+            out << ((phase == 0) ? "" : ", ") << "\"" << PHASE_NAMES[phase] << "\": " << phases[phase];
+        }
+        out << "}";
+    }
+
+    out << ",\n  \"" << FAMILY_NAMES[0] << "\": ";
+    printFamily(out, 0, ipv4Table, ipv4Engine);
+    out << ",\n  \"" << FAMILY_NAMES[1] << "\": ";
+    printFamily(out, 1, ipv6Table, ipv6Engine);
+    out << "\n}" << endl;
+
+    pthread_mutex_unlock(&_mutex);
+}
+
+/**
+ * Prints counters and shape of one table. Bit tries report their nodes per
+ * depth and their prefixes per length, other engines only their memory.
+ * @param out Stream where the report is printed.
+ * @param family Index of the family in the counters.
+ * @param table Searched table.
+ * @param engine Name of the engine.
+ */
+void RuntimeStats::printFamily(ostream &out, int family, const AddrLookupBase &table, const string &engine) {
+    LookupStats stats;
+    table.getStats(stats);
+
+    out << "{\n    \"engine\": \"" << engine << "\""
+        << ",\n    \"prefixes\": " << stats.prefixes
+        << ",\n    \"nodes\": " << stats.nodes
+        << ",\n    \"bytes\": " << stats.bytes
+        << ",\n    \"bytes_per_prefix\": " << ((stats.prefixes == 0) ? 0 : stats.bytes / stats.prefixes);
+    if (stats.uncompressedNodes != 0) {
+        out << ",\n    \"uncompressed_nodes\": " << stats.uncompressedNodes
+            << ",\n    \"uncompressed_bytes\": " << stats.uncompressedBytes;
+    }
+
+    const AddrTrieBase *trie = dynamic_cast<const AddrTrieBase *>(&table);
+    if (trie != NULL) {
+        vector<size_t> depthNodes, prefixLengths;
+        trie->getShape(depthNodes, prefixLengths);
+
+        out << ",\n    \"depth_nodes\": ";
+        printHistogram(out, &depthNodes[0], depthNodes.size());
+        out << ",\n    \"prefix_lengths\": ";
+        printHistogram(out, &prefixLengths[0], prefixLengths.size());
+    }
+
+    if (isEnabled()) {
+        uint64_t depthSum = 0;
+        for (int depth = 0; depth <= 128; depth++) {
+            depthSum += _total.depths[family][depth] * depth;
+        }
+
+        out << ",\n    \"inserts\": " << _total.inserts[family]
+            << ",\n    \"rejected\": " << _total.rejected[family]
+            << ",\n    \"lookups\": " << _total.lookups[family]
+            << ",\n    \"matched\": " << _total.matched[family]
+            << ",\n    \"average_depth\": "
+            << ((_total.lookups[family] == 0) ? 0.0 : (double)depthSum / _total.lookups[family])
+            << ",\n    \"lookup_depths\": ";
+        printHistogram(out, _total.depths[family], 129);
+    }
+    out << "\n  }";
+}
+
+/**
+ * Prints array of the counts as JSON object, zero counts are skipped.
+ * @param out Stream where the object is printed.
+ * @param counts Counts indexed by the key.
+ * @param size Number of the counts.
+ */
+template<typename Count>
+void RuntimeStats::printHistogram(ostream &out, const Count *counts, size_t size) {
+    bool first = true;
+
+    out << "{";
+    for (size_t i = 0; i < size; i++) {
+        if (counts[i] != 0) {
+            out << (first ? "" : ", ") << "\"" << i << "\": " << counts[i];
+            first = false;
+        }
+    }
+    out << "}";
+}
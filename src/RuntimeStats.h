@@ -0,0 +1,182 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       RuntimeStats.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines counters of the running lookups.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file RuntimeStats.h
+ *
+ * @brief Defines counters of the running lookups.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef RUNTIMESTATS_H
+#define RUNTIMESTATS_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <ostream>
+#include <string>
+
+#include "AddrLookupBase.h"
+
+using namespace std;
+
+/**
+ * Counters are compiled in only with -DLPM_STATS (make stats), otherwise
+ * the macros are empty and the hot paths are not changed at all.
+ */
+#ifdef LPM_STATS
+#define LPM_STATS_ADD(counter, n) (RuntimeStats::local().counter += (n))
+#define LPM_STATS_WALK(bitLength, depth, asn) RuntimeStats::countWalk(bitLength, depth, asn)
+#define LPM_STATS_START(start) uint64_t start = RuntimeStats::cycles()
+#define LPM_STATS_RESTART(start) (start = RuntimeStats::cycles())
+#define LPM_STATS_PHASE(phase, start) (RuntimeStats::local().cycles[RuntimeStats::phase] += RuntimeStats::cycles() - (start))
+#else
+#define LPM_STATS_ADD(counter, n) ((void)0)
+#define LPM_STATS_WALK(bitLength, depth, asn) ((void)0)
+#define LPM_STATS_START(start) ((void)0)
+#define LPM_STATS_RESTART(start) ((void)0)
+#define LPM_STATS_PHASE(phase, start) ((void)0)
+#endif
+
+/**
+ * Counters of one thread.
+ */
+struct StatsCounters {
+    uint64_t inserts[2];        /**< Inserted prefixes of IPv4 and IPv6 */
+    uint64_t rejected[2];       /**< Duplicate or invalid prefixes of IPv4 and IPv6 */
+    uint64_t lookups[2];        /**< Walks of the bit trie of IPv4 and IPv6 */
+    uint64_t matched[2];        /**< Walks which have found ASN */
+    uint64_t depths[2][129];    /**< Walks of IPv4 and IPv6 ended at the depth */
+    uint64_t lines;             /**< Searched lines */
+    uint64_t matchedLines;      /**< Lines with found ASN */
+    uint64_t cycles[6];         /**< Cycles spent in the phases */
+};
+
+/**
+ * Counters of the loading and the searching of the tables. Every thread
+ * counts into its own counters without synchronization, they are added into
+ * the totals by merge() when the thread finishes its work. Report with the
+ * totals and the shape of the tables is printed as JSON document.
+ */
+class RuntimeStats
+{
+public:
+    /**
+     * Measured phases of the program.
+     */
+    enum phases {
+        PHASE_LOAD = 0,         /**< Loading of the tables */
+        PHASE_READ = 1,         /**< Reading of the input */
+        PHASE_SEARCH = 2,       /**< Searching of the blocks, includes lookups and formatting */
+        PHASE_LOOKUP = 3,       /**< Searching of the tables */
+        PHASE_FORMAT = 4,       /**< Printing of the ASNs into output buffer */
+        PHASE_WRITE = 5,        /**< Writing of the output */
+        PHASES = 6              /**< Number of the phases */
+               };
+
+    /**
+     * Returns counters of the calling thread.
+     * @return Counters of the calling thread.
+     */
+    static inline StatsCounters &local() {
+        return _local;
+    }
+
+    /**
+     * Returns index of the family in the counters.
+     * @param bitLength Length of the address of the family.
+     * @return 0 for IPv4, 1 for IPv6.
+     */
+    static inline int family(int bitLength) {
+        return (bitLength == 32) ? 0 : 1;
+    }
+
+    /**
+     * Counts finished walk of the bit trie.
+     * @param bitLength Length of the address of the trie.
+     * @param depth Depth of the last visited node.
+     * @param asn Found ASN, or NO_ASN.
+     */
+    static inline void countWalk(int bitLength, int depth, uint32_t asn) {
+        int family = RuntimeStats::family(bitLength);
+        _local.lookups[family]++;
+        _local.matched[family] += (asn != AddrLookupBase::NO_ASN);
+        _local.depths[family][depth]++;
+    }
+
+    /**
+     * Returns current time in cycles, nanoseconds where the time stamp counter is missing.
+     * @return Current time.
+     */
+    static inline uint64_t cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __builtin_ia32_rdtsc();
+#else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+    }
+
+    /**
+     * Adds counters of the calling thread into totals and clears them.
+     */
+    static void merge();
+
+    /**
+     * Prints counters and shape of the tables as JSON document.
+     * @param out Stream where the report is printed.
+     * @param ipv4Table Searched IPv4 table.
+     * @param ipv6Table Searched IPv6 table.
+     * @param ipv4Engine Name of the IPv4 engine.
+     * @param ipv6Engine Name of the IPv6 engine.
+     */
+    static void printReport(ostream &out, const AddrLookupBase &ipv4Table, const AddrLookupBase &ipv6Table,
+                            const string &ipv4Engine, const string &ipv6Engine);
+
+    /**
+     * Tells whether the counters are compiled in.
+     * @return True if the program was compiled with LPM_STATS.
+     */
+    static inline bool isEnabled() {
+#ifdef LPM_STATS
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    static __thread StatsCounters _local;   /**< Counters of the thread */
+    static StatsCounters _total;            /**< Counters of the finished threads */
+    static pthread_mutex_t _mutex;          /**< Guards the totals */
+
+    /**
+     * Prints counters and shape of one table.
+     * @param out Stream where the report is printed.
+     * @param family Index of the family in the counters.
+     * @param table Searched table.
+     * @param engine Name of the engine.
+     */
+    static void printFamily(ostream &out, int family, const AddrLookupBase &table, const string &engine);
+
+    /**
+     * Prints array of the counts as JSON object, zero counts are skipped.
+     * @param out Stream where the object is printed.
+     * @param counts Counts indexed by the key.
+     * @param size Number of the counts.
+     */
+    template<typename Count>
+    static void printHistogram(ostream &out, const Count *counts, size_t size);
+};
+
+#endif // RUNTIMESTATS_H
@@ -0,0 +1,233 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       SearchPipeline.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing multi-threaded searching pipeline.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file SearchPipeline.cpp
+ *
+ * @brief Implements multi-threaded searching pipeline.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstring>
+
+#include <unistd.h>
+
+#include "LineSearcher.h"
+#include "RuntimeStats.h"
+#include "SearchPipeline.h"
+
+const size_t SearchPipeline::CHUNK_SIZE;
+
+/**
+ * Constructs pipeline, threads are started by run().
+ * @param tables Holder of the searched tables.
+ * @param threads Number of the worker threads.
+ * @param cacheEntries Number of the cached addresses of each family per worker, 0 disables the cache.
+ * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+ */
+SearchPipeline::SearchPipeline(TableReloader &tables, int threads, size_t cacheEntries, bool binaryOutput)
+    : _tables(tables), _threads(threads), _filled(0), _taken(0), _finished(false),
+      _cacheEntries(cacheEntries), _binaryOutput(binaryOutput), _cacheHits(0), _cacheMisses(0)
+{
+    // Two slots per worker, so workers have next chunk ready while the results are written
+    _slots.resize(2 * threads);
+    for (size_t i = 0; i < _slots.size(); i++) {
+        _slots[i].input = new char[CHUNK_SIZE + 1];
+        _slots[i].length = 0;
+        _slots[i].output = new OutputBuffer(CHUNK_SIZE);
+        _slots[i].done = true;
+    }
+
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_filledCond, NULL);
+    pthread_cond_init(&_doneCond, NULL);
+}
+
+/**
+ * Destructor of the pipeline.
+ */
+SearchPipeline::~SearchPipeline()
+{
+    for (size_t i = 0; i < _slots.size(); i++) {
+        delete[] _slots[i].input;
+        delete _slots[i].output;
+    }
+
+    pthread_mutex_destroy(&_mutex);
+    pthread_cond_destroy(&_filledCond);
+    pthread_cond_destroy(&_doneCond);
+}
+
+/**
+ * Searches all lines of the input and writes results in input order.
+ * @param inFd File descriptor with lines of addresses.
+ * @param outFd File descriptor where should be results written.
+ * @return True if no error occurs, false if writing has failed.
+ */
+bool SearchPipeline::run(int inFd, int outFd) {
+    size_t ringSize = _slots.size();
+    size_t seq = 0;
+    bool ok = true;
+    bool more = true;
+
+    for (size_t i = 0; i < _threads.size(); i++) {
+        pthread_create(&_threads[i], NULL, workerThread, this);
+    }
+
+    /* Fill the slots around the ring, previous results of the slot are written before */
+    while (ok && more) {
+        SearchSlot &slot = _slots[seq % ringSize];
+
+        if ((seq >= ringSize) && !writeSlot(slot, outFd)) {
+            ok = false;
+            break;
+        }
+
+        more = fillSlot(slot, inFd);
+
+        pthread_mutex_lock(&_mutex);
+        slot.done = false;
+        _filled = ++seq;
+        pthread_cond_signal(&_filledCond);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    /* Write results of the slots which are left in the ring */
+    for (size_t i = (seq > ringSize) ? seq - ringSize : 0; ok && (i < seq); i++) {
+        ok = writeSlot(_slots[i % ringSize], outFd);
+    }
+
+    pthread_mutex_lock(&_mutex);
+    _finished = true;
+    pthread_cond_broadcast(&_filledCond);
+    pthread_mutex_unlock(&_mutex);
+
+    for (size_t i = 0; i < _threads.size(); i++) {
+        pthread_join(_threads[i], NULL);
+    }
+
+    return ok;
+}
+
+/**
+ * Entry point of the worker thread.
+ * @param pipeline Pipeline which runs the thread.
+ * @return Always NULL.
+ */
+void *SearchPipeline::workerThread(void *pipeline) {
+    static_cast<SearchPipeline *>(pipeline)->work();
+    return NULL;
+}
+
+/**
+ * Searches filled chunks until the pipeline is finished.
+ */
+void SearchPipeline::work() {
+    LineSearcher searcher(false, _cacheEntries, _binaryOutput);
+    RcuReader *reader = _tables.registerReader();
+
+    while (true) {
+        pthread_mutex_lock(&_mutex);
+        while ((_taken == _filled) && !_finished) {
+            pthread_cond_wait(&_filledCond, &_mutex);
+        }
+
+        if (_taken == _filled) {     // Pipeline is finished and all chunks are taken
+            pthread_mutex_unlock(&_mutex);
+            break;
+        }
+
+        SearchSlot &slot = _slots[_taken++ % _slots.size()];
+        pthread_mutex_unlock(&_mutex);
+
+        // Unbound output only grows, so searching never fails.
+        // Version is read first, so the results cached under it are never older than it.
+        unsigned long version = _tables.getVersion();
+        const TableSet *tables = _tables.readLock(reader);
+        char *rest;
+        searcher.setTables(*tables->ipv4, *tables->ipv6, version);
+        LPM_STATS_START(start);
+        searcher.searchBlock(slot.input, slot.length, rest, *slot.output);
+        searcher.finish(*slot.output);
+        LPM_STATS_PHASE(PHASE_SEARCH, start);
+        _tables.readUnlock(reader);
+
+        pthread_mutex_lock(&_mutex);
+        slot.done = true;
+        pthread_cond_broadcast(&_doneCond);
+        pthread_mutex_unlock(&_mutex);
+    }
+
+    _tables.unregisterReader(reader);
+
+    pthread_mutex_lock(&_mutex);
+    _cacheHits += searcher.getCacheHits();
+    _cacheMisses += searcher.getCacheMisses();
+    pthread_mutex_unlock(&_mutex);
+
+    RuntimeStats::merge();
+}
+
+/**
+ * Reads next chunk of the complete lines into slot.
+ * @param slot Slot which should be filled.
+ * @param inFd File descriptor with lines of addresses.
+ * @return False if end of the input has been reached, else true.
+ */
+bool SearchPipeline::fillSlot(SearchSlot &slot, int inFd) {
+    size_t size = _carry.size();
+    bool more = true;
+
+    if (size != 0) {
+        memcpy(slot.input, &_carry[0], size);
+        _carry.clear();
+    }
+
+    LPM_STATS_START(start);
+    while (size < CHUNK_SIZE) {
+        ssize_t read_bytes = read(inFd, &slot.input[size], CHUNK_SIZE - size);
+        if (read_bytes <= 0) {
+            more = false;
+            break;
+        }
+        size += read_bytes;
+    }
+    LPM_STATS_PHASE(PHASE_READ, start);
+
+    /* Chunk ends behind the last new line, incomplete line is moved to the next chunk */
+    size_t end = size;
+    while ((end > 0) && (slot.input[end - 1] != '\n')) {
+        end--;
+    }
+
+    if (more && (end != 0)) {   // Line longer than the whole chunk is skipped
+        _carry.assign(&slot.input[end], &slot.input[size]);
+    }
+    slot.input[end] = '\0';
+    slot.length = end;
+
+    return more;
+}
+
+/**
+ * Waits until the chunk of the slot is searched and writes its results.
+ * @param slot Slot whose results should be written.
+ * @param outFd File descriptor where should be results written.
+ * @return True if no error occurs, else false.
+ */
+bool SearchPipeline::writeSlot(SearchSlot &slot, int outFd) {
+    pthread_mutex_lock(&_mutex);
+    while (!slot.done) {
+        pthread_cond_wait(&_doneCond, &_mutex);
+    }
+    pthread_mutex_unlock(&_mutex);
+
+    return slot.output->writeTo(outFd);
+}
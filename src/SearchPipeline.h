@@ -0,0 +1,140 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       SearchPipeline.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines multi-threaded searching pipeline.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file SearchPipeline.h
+ *
+ * @brief Defines multi-threaded searching pipeline.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef SEARCHPIPELINE_H
+#define SEARCHPIPELINE_H
+
+#include <pthread.h>
+
+#include <vector>
+
+#include "OutputBuffer.h"
+#include "TableReloader.h"
+
+using namespace std;
+
+/**
+ * Multi-threaded searching of the addresses given by lines. Calling thread
+ * reads input in chunks which end on the line boundary, worker threads search
+ * them over the shared read-only tables and calling thread writes results
+ * of the chunks in input order. Chunks go around the ring of slots, so slot
+ * is written out just before it is filled again. Every worker has its own
+ * cache of the results, so the workers do not share any written memory.
+ */
+class SearchPipeline
+{
+public:
+    /**
+     * Constructs pipeline, threads are started by run().
+     * @param tables Holder of the searched tables.
+     * @param threads Number of the worker threads.
+     * @param cacheEntries Number of the cached addresses of each family per worker, 0 disables the cache.
+     * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+     */
+    SearchPipeline(TableReloader &tables, int threads, size_t cacheEntries = 0, bool binaryOutput = false);
+
+    /**
+     * Destructor of the pipeline.
+     */
+    ~SearchPipeline();
+
+    /**
+     * Searches all lines of the input and writes results in input order.
+     * @param inFd File descriptor with lines of addresses.
+     * @param outFd File descriptor where should be results written.
+     * @return True if no error occurs, false if writing has failed.
+     */
+    bool run(int inFd, int outFd);
+
+    /**
+     * Returns number of the addresses answered from the caches of the workers.
+     * @return Number of the cache hits.
+     */
+    inline size_t getCacheHits() const {
+        return _cacheHits;
+    }
+
+    /**
+     * Returns number of the addresses searched in the tables despite the caches.
+     * @return Number of the cache misses.
+     */
+    inline size_t getCacheMisses() const {
+        return _cacheMisses;
+    }
+
+    const static size_t CHUNK_SIZE = 262144;  /**< Size of the input chunk */
+
+private:
+    /**
+     * Slot of the ring with one chunk of the input.
+     */
+    struct SearchSlot {
+        char *input;            /**< NUL terminated chunk of the complete lines */
+        size_t length;          /**< Length of the chunk */
+        OutputBuffer *output;   /**< Results of the chunk */
+        bool done;              /**< Chunk has been searched */
+    };
+
+    TableReloader &_tables;     /**< Holder of the searched tables */
+    vector<SearchSlot> _slots;  /**< Ring of the slots */
+    vector<pthread_t> _threads; /**< Worker threads */
+    vector<char> _carry;        /**< Incomplete last line of the previous chunk */
+
+    pthread_mutex_t _mutex;     /**< Guards the counters and done flags */
+    pthread_cond_t _filledCond; /**< Signaled when chunk is filled or pipeline finished */
+    pthread_cond_t _doneCond;   /**< Signaled when chunk is searched */
+    size_t _filled;             /**< Number of the filled chunks */
+    size_t _taken;              /**< Number of the chunks taken by workers */
+    bool _finished;             /**< No more chunks will be filled */
+    size_t _cacheEntries;       /**< Number of the cached addresses of each family per worker */
+    bool _binaryOutput;         /**< ASNs are printed as packed 32 bit numbers */
+    size_t _cacheHits;          /**< Cache hits of the finished workers */
+    size_t _cacheMisses;        /**< Cache misses of the finished workers */
+
+    /**
+     * Entry point of the worker thread.
+     * @param pipeline Pipeline which runs the thread.
+     * @return Always NULL.
+     */
+    static void *workerThread(void *pipeline);
+
+    /**
+     * Searches filled chunks until the pipeline is finished.
+     */
+    void work();
+
+    /**
+     * Reads next chunk of the complete lines into slot.
+     * @param slot Slot which should be filled.
+     * @param inFd File descriptor with lines of addresses.
+     * @return False if end of the input has been reached, else true.
+     */
+    bool fillSlot(SearchSlot &slot, int inFd);
+
+    /**
+     * Waits until the chunk of the slot is searched and writes its results.
+     * @param slot Slot whose results should be written.
+     * @param outFd File descriptor where should be results written.
+     * @return True if no error occurs, else false.
+     */
+    bool writeSlot(SearchSlot &slot, int outFd);
+
+    SearchPipeline(const SearchPipeline &);
+    SearchPipeline &operator=(const SearchPipeline &);
+};
+
+#endif // SEARCHPIPELINE_H
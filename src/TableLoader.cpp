@@ -0,0 +1,278 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       TableLoader.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing loader of the ASN tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file TableLoader.cpp
+ *
+ * @brief Implements loader of the ASN tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "AddrTrie.h"
+#include "TableLoader.h"
+
+/**
+ * Constructs loader into the tables.
+ * @param ipv4Trie Trie where IPv4 to ASN mapping will be stored.
+ * @param ipv6Trie Trie where IPv6 to ASN mapping will be stored.
+ * @param aggregate Insert the smallest set of the prefixes with the same results instead of the loaded ones.
+ */
+TableLoader::TableLoader(AddrLookupBase &ipv4Trie, AddrLookupBase &ipv6Trie, bool aggregate) : _aggregate(aggregate)
+{
+    _tries[LOADER_IPV4] = &ipv4Trie;
+    _tries[LOADER_IPV6] = &ipv6Trie;
+    memset(_before, 0, sizeof(_before));
+    memset(_after, 0, sizeof(_after));
+}
+
+/**
+ * Loads numbers of autonomous systems from the file into tables.
+ * @param filename Filename of the file with AS numbers.
+ * @param threads Number of the threads used for parsing and building.
+ * @return True if no error occurs, false if the file could not be read.
+ */
+bool TableLoader::load(const string &filename, int threads) {
+    int asnFile = open(filename.c_str(), O_RDONLY);
+    if (asnFile == -1) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if (fstat(asnFile, &fileStat) == -1) {
+        close(asnFile);
+        return false;
+    }
+
+    size_t size = fileStat.st_size;
+    if (size == 0) {                 // Nothing to map, tables stay empty
+        close(asnFile);
+        return true;
+    }
+
+    void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, asnFile, 0);
+    close(asnFile);                  // Mapping stays valid without the descriptor
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    madvise(mapped, size, MADV_SEQUENTIAL);
+
+    // Aggregated records are loaded into bit tries first
+    AddrTrie<IPv4AddrFamily> ipv4Source;
+    AddrTrie<IPv6AddrFamily> ipv6Source;
+    AddrTrieBase *sources[LOADER_FAMILIES] = {&ipv4Source, &ipv6Source};
+    AddrLookupBase *tables[LOADER_FAMILIES] = {_tries[LOADER_IPV4], _tries[LOADER_IPV6]};
+    if (_aggregate) {
+        _tries[LOADER_IPV4] = &ipv4Source;
+        _tries[LOADER_IPV6] = &ipv6Source;
+    }
+
+    if (threads > 1) {
+        loadParallel(static_cast<const char *>(mapped), size, threads);
+    } else {
+        loadSequential(static_cast<const char *>(mapped), size);
+    }
+
+    if (_aggregate) {
+        for (int family = 0; family < LOADER_FAMILIES; family++) {
+            _tries[family] = tables[family];
+            aggregateInto(family, *sources[family], *tables[family], threads);
+        }
+    }
+
+    for (int family = 0; family < LOADER_FAMILIES; family++) {
+        _tries[family]->build();
+    }
+
+    munmap(mapped, size);
+    return true;
+}
+
+/**
+ * Parses and inserts records one by one.
+ * @param data Content of the file.
+ * @param size Size of the content.
+ */
+void TableLoader::loadSequential(const char *data, size_t size) {
+    const char *lineChars = data;
+    const char *fileEnd = data + size;
+    PrefixRecord record;
+
+    // Parsing loop, every line is bounded by its start and end pointer
+    while (lineChars < fileEnd) {
+        const char *lineEnd = static_cast<const char *>(memchr(lineChars, '\n', fileEnd - lineChars));
+        if (lineEnd == NULL) {       // Last line without new line character
+            lineEnd = fileEnd;
+        }
+
+        int family = parseRecord(lineChars, lineEnd, record);
+        if (family != -1) {          // Insert new record into trie of the family
+            _tries[family]->insertASN(record.addr, record.prefix, record.asn);
+        }
+
+        lineChars = lineEnd + 1;
+    }
+}
+
+/**
+ * Parses slices of the file by more threads and inserts parsed records into tables.
+ * @param data Content of the file.
+ * @param size Size of the content.
+ * @param threads Number of the threads.
+ */
+void TableLoader::loadParallel(const char *data, size_t size, int threads) {
+    const char *fileEnd = data + size;
+    LoaderSlice *slices = new LoaderSlice[threads];
+
+    /* Slices have similar size and end behind the new line character */
+    const char *sliceChars = data;
+    for (int i = 0; i < threads; i++) {
+        const char *sliceEnd = (i == threads - 1) ? fileEnd : data + size * (i + 1) / threads;
+        if (sliceEnd < sliceChars) {
+            sliceEnd = sliceChars;
+        }
+
+        const char *lineEnd = static_cast<const char *>(memchr(sliceEnd, '\n', fileEnd - sliceEnd));
+        sliceEnd = (lineEnd == NULL) ? fileEnd : lineEnd + 1;
+
+        slices[i].loader = this;
+        slices[i].begin = sliceChars;
+        slices[i].end = sliceEnd;
+        pthread_create(&slices[i].thread, NULL, parseSlice, &slices[i]);
+
+        sliceChars = sliceEnd;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        pthread_join(slices[i].thread, NULL);
+    }
+
+    /* Records are inserted in the file order, tables decide how to use the threads */
+    vector<PrefixRecord> *records = new vector<PrefixRecord>[threads];
+    for (int family = 0; family < LOADER_FAMILIES; family++) {
+        for (int i = 0; i < threads; i++) {
+            records[i].swap(slices[i].records[family]);
+        }
+
+        _tries[family]->insertRecords(records, threads, threads);
+
+        for (int i = 0; i < threads; i++) {
+            vector<PrefixRecord>().swap(records[i]);  // Release memory of the records
+        }
+    }
+
+    delete[] records;
+    delete[] slices;
+}
+
+/**
+ * Entry point of the thread which parses the slice.
+ * @param slicePtr Slice which should be parsed.
+ * @return Always NULL.
+ */
+void *TableLoader::parseSlice(void *slicePtr) {
+    LoaderSlice &slice = *static_cast<LoaderSlice *>(slicePtr);
+    const char *lineChars = slice.begin;
+    PrefixRecord record;
+
+    while (lineChars < slice.end) {
+        const char *lineEnd = static_cast<const char *>(memchr(lineChars, '\n', slice.end - lineChars));
+        if (lineEnd == NULL) {       // Last line without new line character
+            lineEnd = slice.end;
+        }
+
+        int family = slice.loader->parseRecord(lineChars, lineEnd, record);
+        if (family != -1) {
+            slice.records[family].push_back(record);
+        }
+
+        lineChars = lineEnd + 1;
+    }
+
+    return NULL;
+}
+
+/**
+ * Inserts the smallest set of the prefixes of the loaded bit trie into the table.
+ * @param family Loader family of the tables.
+ * @param source Bit trie with the loaded prefixes.
+ * @param table Table where the aggregated prefixes are inserted.
+ * @param threads Number of the threads used for building.
+ */
+void TableLoader::aggregateInto(int family, AddrTrieBase &source, AddrLookupBase &table, int threads) {
+    vector<PrefixRecord> records;
+
+    source.getStats(_before[family]);
+    _after[family].nodes = source.aggregate(records);
+    _after[family].prefixes = records.size();
+    _after[family].bytes = _after[family].nodes * sizeof(TrieNode);
+
+    table.insertRecords(&records, 1, threads);
+}
+
+/**
+ * Parses record of the line.
+ * @param lineChars First character of the line.
+ * @param lineEnd End of the line (without new line character).
+ * @param record Parsed record.
+ * @return Loader family of the record, or -1 for malformed line.
+ */
+int TableLoader::parseRecord(const char *lineChars, const char *lineEnd, PrefixRecord &record) {
+    int family = LOADER_IPV4;
+
+    // Parsing of the address stops on '/' at the latest, so it never reads behind the mapped file
+    const char *prefixChars = static_cast<const char *>(memchr(lineChars, '/', lineEnd - lineChars));
+    if (prefixChars == NULL) {
+        return -1;
+    }
+
+    /* Address is parsed right from the line, it has to end by '/' */
+    memset(record.addr, 0, sizeof(record.addr));
+    size_t ipLength = IPv4AddrFamily::parse(lineChars, record.addr);
+    if ((ipLength == 0) || (lineChars + ipLength != prefixChars)) {
+        family = LOADER_IPV6;
+        ipLength = IPv6AddrFamily::parse(lineChars, record.addr);
+    }
+
+    if ((ipLength == 0) || (lineChars + ipLength != prefixChars)) {
+        return -1;
+    }
+
+    /* Convert prefix number and ASN into numerical representation, out of range values reject the record */
+    uint32_t prefix;
+    uint32_t maxPrefix = (family == LOADER_IPV4) ? IPv4AddrFamily::BIT_LENGTH : IPv6AddrFamily::BIT_LENGTH;
+    const char *asnChars = parseNumber(prefixChars + 1, lineEnd, maxPrefix, prefix);
+    if ((asnChars == NULL) || (asnChars == lineEnd) || ((*asnChars != ' ') && (*asnChars != '\t'))) {
+        return -1;      // ASN has to be separated from the prefix length
+    }
+    while ((asnChars != lineEnd) && ((*asnChars == ' ') || (*asnChars == '\t'))) {
+        asnChars++;
+    }
+    const char *tailChars = parseNumber(asnChars, lineEnd, 0xFFFFFFFF, record.asn);
+    if (tailChars == NULL) {
+        return -1;
+    }
+    while ((tailChars != lineEnd) && ((*tailChars == ' ') || (*tailChars == '\t') || (*tailChars == '\r'))) {
+        tailChars++;
+    }
+    if (tailChars != lineEnd) {     // Nothing but white space may follow the ASN
+        return -1;
+    }
+    record.prefix = prefix;
+
+    return family;
+}
@@ -0,0 +1,168 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       TableLoader.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines loader of the ASN tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file TableLoader.h
+ *
+ * @brief Defines loader of the ASN tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef TABLELOADER_H
+#define TABLELOADER_H
+
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+
+#include "AddrLookupBase.h"
+
+using namespace std;
+
+class AddrTrieBase;
+
+/**
+ * Loader of the file with ASN records "address/prefix asn" into IPv4 and IPv6
+ * tables. File is mapped into memory and parsed in place without modifying it,
+ * malformed lines are skipped. Parallel load parses slices of the file by more
+ * threads and lets the tables build themselves from the parsed records.
+ * Aggregating loader loads records into bit tries first, replaces them by
+ * the smallest set of the prefixes with the same results and inserts only
+ * these into the tables.
+ */
+class TableLoader
+{
+public:
+    /**
+     * Constructs loader into the tables.
+     * @param ipv4Trie Trie where IPv4 to ASN mapping will be stored.
+     * @param ipv6Trie Trie where IPv6 to ASN mapping will be stored.
+     * @param aggregate Insert the smallest set of the prefixes with the same results instead of the loaded ones.
+     */
+    TableLoader(AddrLookupBase &ipv4Trie, AddrLookupBase &ipv6Trie, bool aggregate = false);
+
+    /**
+     * Loads numbers of autonomous systems from the file into tables.
+     * @param filename Filename of the file with AS numbers.
+     * @param threads Number of the threads used for parsing and building.
+     * @return True if no error occurs, false if the file could not be read.
+     */
+    bool load(const string &filename, int threads);
+
+    /**
+     * Returns statistics of the bit trie with the loaded prefixes, filled only by aggregating loader.
+     * @param family 0 for IPv4, 1 for IPv6.
+     * @return Statistics before the aggregation.
+     */
+    inline const LookupStats &getStatsBefore(int family) const {
+        return _before[family];
+    }
+
+    /**
+     * Returns statistics of the bit trie with the aggregated prefixes, filled only by aggregating loader.
+     * Memory is given by the used nodes.
+     * @param family 0 for IPv4, 1 for IPv6.
+     * @return Statistics after the aggregation.
+     */
+    inline const LookupStats &getStatsAfter(int family) const {
+        return _after[family];
+    }
+
+private:
+    /**
+     * Indices of the address families of the parsed records.
+     */
+    enum loaderFamilies {
+        LOADER_IPV4 = 0,    /**< IPv4 records */
+        LOADER_IPV6 = 1,    /**< IPv6 records */
+        LOADER_FAMILIES = 2 /**< Number of the families */
+                };
+
+    /**
+     * Slice of the file which is parsed by one thread.
+     */
+    struct LoaderSlice {
+        TableLoader *loader;                        /**< Loader which parses the slice */
+        const char *begin;                          /**< First line of the slice */
+        const char *end;                            /**< End of the slice */
+        vector<PrefixRecord> records[LOADER_FAMILIES]; /**< Parsed records of the families */
+        pthread_t thread;                           /**< Thread which parses the slice */
+    };
+
+    AddrLookupBase *_tries[LOADER_FAMILIES];        /**< Tables indexed by the loader family */
+    bool _aggregate;                                /**< Tables get the aggregated prefixes */
+    LookupStats _before[LOADER_FAMILIES];           /**< Bit tries before the aggregation */
+    LookupStats _after[LOADER_FAMILIES];            /**< Bit tries after the aggregation */
+
+    /**
+     * Parses and inserts records one by one.
+     * @param data Content of the file.
+     * @param size Size of the content.
+     */
+    void loadSequential(const char *data, size_t size);
+
+    /**
+     * Parses slices of the file by more threads and inserts parsed records into tables.
+     * @param data Content of the file.
+     * @param size Size of the content.
+     * @param threads Number of the threads.
+     */
+    void loadParallel(const char *data, size_t size, int threads);
+
+    /**
+     * Entry point of the thread which parses the slice.
+     * @param slicePtr Slice which should be parsed.
+     * @return Always NULL.
+     */
+    static void *parseSlice(void *slicePtr);
+
+    /**
+     * Inserts the smallest set of the prefixes of the loaded bit trie into the table.
+     * @param family Loader family of the tables.
+     * @param source Bit trie with the loaded prefixes.
+     * @param table Table where the aggregated prefixes are inserted.
+     * @param threads Number of the threads used for building.
+     */
+    void aggregateInto(int family, AddrTrieBase &source, AddrLookupBase &table, int threads);
+
+    /**
+     * Parses record of the line.
+     * @param lineChars First character of the line.
+     * @param lineEnd End of the line (without new line character).
+     * @param record Parsed record.
+     * @return Loader family of the record, or -1 for malformed line.
+     */
+    int parseRecord(const char *lineChars, const char *lineEnd, PrefixRecord &record);
+
+    /**
+     * Parses decimal number from the characters, parsing stops on the first non digit character.
+     * @param chars First character of the number.
+     * @param end End of the characters.
+     * @param max The greatest allowed value of the number.
+     * @param number Parsed number.
+     * @return Position behind the number, or NULL if there are no digits or the number is greater than max.
+     */
+    static inline const char *parseNumber(const char *chars, const char *end, uint32_t max, uint32_t &number) {
+        const char *digits = chars;
+        number = 0;
+        while ((chars != end) && (*chars >= '0') && (*chars <= '9')) {
+            uint32_t digit = *chars++ - '0';
+            if (number > (max - digit) / 10) {  // Stop before the number overflows
+                return NULL;
+            }
+            number = number * 10 + digit;
+        }
+
+        return (chars == digits) ? NULL : chars;
+    }
+};
+
+#endif // TABLELOADER_H
@@ -0,0 +1,152 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       TableReloader.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing hot reload of the ASN tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file TableReloader.cpp
+ *
+ * @brief Implements hot reload of the ASN tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <csignal>
+#include <ctime>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "TableReloader.h"
+
+const int TableReloader::WATCH_INTERVAL;
+
+/**
+ * Constructs holder without tables, they are loaded by reload() and reloading is started by start().
+ * @param loader Function which builds new tables.
+ * @param context Context passed to the loader.
+ */
+TableReloader::TableReloader(TableSetLoader loader, void *context)
+    : _tables(NULL), _loader(loader), _context(context), _running(false), _stopping(false), _version(0)
+{
+}
+
+/**
+ * Destructor, stops reloading and deletes current tables.
+ */
+TableReloader::~TableReloader()
+{
+    stop();
+    delete _tables.get();
+}
+
+/**
+ * Starts reload thread. SIGHUP is blocked in the calling thread, so it has
+ * to be called before other threads are created, they inherit the mask.
+ * @param filename File whose changes trigger the reload.
+ * @return True if the thread has been started, else false.
+ */
+bool TableReloader::start(const string &filename) {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+
+    // SIGHUP is received only by sigtimedwait() of the reload thread
+    if (pthread_sigmask(SIG_BLOCK, &signals, NULL) != 0) {
+        return false;
+    }
+
+    _filename = filename;
+    _stopping = false;
+    _running = (pthread_create(&_thread, NULL, reloadThread, this) == 0);
+
+    return _running;
+}
+
+/**
+ * Stops reload thread.
+ */
+void TableReloader::stop() {
+    if (!_running) {
+        return;
+    }
+
+    __atomic_store_n(&_stopping, true, __ATOMIC_RELEASE);
+    pthread_kill(_thread, SIGHUP);  // Wakes up the waiting thread
+    pthread_join(_thread, NULL);
+    _running = false;
+}
+
+/**
+ * Builds new tables and replaces current ones, current tables stay on failure.
+ * Only one thread may reload at time.
+ * @return True if the tables have been replaced, else false.
+ */
+bool TableReloader::reload() {
+    TableSet *tables = _loader(_context);
+    if (tables == NULL) {
+        return false;
+    }
+
+    TableSet *oldTables = _tables.exchange(tables);
+    markUpdated();
+    _rcu.synchronize();         // No reader can see the old tables from now
+    delete oldTables;
+
+    return true;
+}
+
+/**
+ * Entry point of the reload thread.
+ * @param reloader Reloader which runs the thread.
+ * @return Always NULL.
+ */
+void *TableReloader::reloadThread(void *reloader) {
+    static_cast<TableReloader *>(reloader)->watch();
+    return NULL;
+}
+
+/**
+ * Waits for SIGHUP or change of the watched file and reloads the tables.
+ */
+void TableReloader::watch() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGHUP);
+
+    struct stat lastStat;
+    bool exists = (stat(_filename.c_str(), &lastStat) == 0);
+    bool changed = false;
+
+    while (!__atomic_load_n(&_stopping, __ATOMIC_ACQUIRE)) {
+        struct timespec timeout;
+        timeout.tv_sec = WATCH_INTERVAL;
+        timeout.tv_nsec = 0;
+
+        int signal = sigtimedwait(&signals, NULL, &timeout);
+        if (__atomic_load_n(&_stopping, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        /* Changed file is loaded when it has not been changed for one interval, so it is not half written */
+        struct stat fileStat;
+        bool modified = false;
+        if (stat(_filename.c_str(), &fileStat) == 0) {
+            modified = !exists || (fileStat.st_mtime != lastStat.st_mtime) || (fileStat.st_size != lastStat.st_size)
+                       || (fileStat.st_ino != lastStat.st_ino);
+            lastStat = fileStat;
+            exists = true;
+        }
+
+        if ((signal == SIGHUP) || (changed && !modified)) {
+            reload();
+            changed = false;
+        } else if (modified) {
+            changed = true;
+        }
+    }
+}
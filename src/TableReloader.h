@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       TableReloader.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines hot reload of the ASN tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file TableReloader.h
+ *
+ * @brief Defines hot reload of the ASN tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef TABLERELOADER_H
+#define TABLERELOADER_H
+
+#include <pthread.h>
+
+#include <string>
+
+#include "AddrLookupBase.h"
+#include "Rcu.h"
+#include "TableSnapshot.h"
+
+using namespace std;
+
+/**
+ * Complete IPv4 and IPv6 tables which are searched together.
+ */
+struct TableSet {
+    AddrLookupBase *ipv4;       /**< Searching trie for IPv4 addresses */
+    AddrLookupBase *ipv6;       /**< Searching trie for IPv6 addresses */
+    TableSnapshot *snapshot;    /**< Snapshot which the tries are attached to, or NULL */
+
+    /**
+     * Constructs empty set.
+     */
+    TableSet() : ipv4(NULL), ipv6(NULL), snapshot(NULL) {}
+
+    /**
+     * Destructor, tries are deleted before their snapshot.
+     */
+    ~TableSet() {
+        delete ipv4;
+        delete ipv6;
+        delete snapshot;
+    }
+
+private:
+    TableSet(const TableSet &);
+    TableSet &operator=(const TableSet &);
+};
+
+/**
+ * Function which builds new set of the tables.
+ * @param context Context passed to the reloader.
+ * @return New tables or NULL if they could not be built.
+ */
+typedef TableSet *(*TableSetLoader)(void *context);
+
+/**
+ * Holder of the currently searched tables. Searching threads read the tables
+ * inside RCU critical section, so they never wait for the reload. Reload
+ * thread builds new tables aside on SIGHUP or when the watched file has been
+ * changed, publishes them by atomic pointer swap and frees the old tables
+ * when no reader can use them anymore.
+ */
+class TableReloader
+{
+public:
+    /**
+     * Constructs holder without tables, they are loaded by reload() and reloading is started by start().
+     * @param loader Function which builds new tables.
+     * @param context Context passed to the loader.
+     */
+    TableReloader(TableSetLoader loader, void *context);
+
+    /**
+     * Destructor, stops reloading and deletes current tables.
+     */
+    ~TableReloader();
+
+    /**
+     * Starts reload thread. SIGHUP is blocked in the calling thread, so it has
+     * to be called before other threads are created, they inherit the mask.
+     * @param filename File whose changes trigger the reload.
+     * @return True if the thread has been started, else false.
+     */
+    bool start(const string &filename);
+
+    /**
+     * Stops reload thread.
+     */
+    void stop();
+
+    /**
+     * Builds new tables and replaces current ones, current tables stay on failure.
+     * Only one thread may reload at time.
+     * @return True if the tables have been replaced, else false.
+     */
+    bool reload();
+
+    /**
+     * Returns domain of the readers, tables which are modified in place retire their nodes through it.
+     * @return Domain of the readers.
+     */
+    inline RcuDomain &getRcu() {
+        return _rcu;
+    }
+
+    /**
+     * Registers reader of the calling thread.
+     * @return Reader which is passed into readLock() and readUnlock().
+     */
+    inline RcuReader *registerReader() {
+        return _rcu.registerReader();
+    }
+
+    /**
+     * Unregisters reader of the calling thread.
+     * @param reader Reader which should be unregistered.
+     */
+    inline void unregisterReader(RcuReader *reader) {
+        _rcu.unregisterReader(reader);
+    }
+
+    /**
+     * Gets current tables, they stay valid until readUnlock().
+     * @param reader Reader of the calling thread.
+     * @return Current tables.
+     */
+    inline const TableSet *readLock(RcuReader *reader) {
+        _rcu.readLock(reader);
+        return _tables.get();
+    }
+
+    /**
+     * Releases tables obtained by readLock().
+     * @param reader Reader of the calling thread.
+     */
+    inline void readUnlock(RcuReader *reader) {
+        _rcu.readUnlock(reader);
+    }
+
+    /**
+     * Returns version of the tables, it changes whenever the tables are reloaded or updated.
+     * @return Version of the tables.
+     */
+    inline unsigned long getVersion() const {
+        return __atomic_load_n(&_version, __ATOMIC_ACQUIRE);
+    }
+
+    /**
+     * Marks that the current tables have been modified in place.
+     */
+    inline void markUpdated() {
+        __atomic_add_fetch(&_version, 1, __ATOMIC_RELEASE);
+    }
+
+    const static int WATCH_INTERVAL = 1;    /**< Interval of checking the watched file in seconds */
+
+private:
+    RcuDomain _rcu;                 /**< Readers of the tables */
+    RcuPointer<TableSet> _tables;   /**< Current tables */
+    TableSetLoader _loader;         /**< Function which builds new tables */
+    void *_context;                 /**< Context passed to the loader */
+    string _filename;               /**< Watched file */
+    pthread_t _thread;              /**< Reload thread */
+    bool _running;                  /**< Reload thread has been started */
+    bool _stopping;                 /**< Reload thread should finish, accessed atomically */
+    unsigned long _version;         /**< Version of the tables, accessed atomically */
+
+    /**
+     * Entry point of the reload thread.
+     * @param reloader Reloader which runs the thread.
+     * @return Always NULL.
+     */
+    static void *reloadThread(void *reloader);
+
+    /**
+     * Waits for SIGHUP or change of the watched file and reloads the tables.
+     */
+    void watch();
+
+    TableReloader(const TableReloader &);
+    TableReloader &operator=(const TableReloader &);
+};
+
+#endif // TABLERELOADER_H
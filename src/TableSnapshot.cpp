@@ -0,0 +1,279 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       TableSnapshot.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Source file implementing binary snapshot of the compiled tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file TableSnapshot.cpp
+ *
+ * @brief Implements binary snapshot of the compiled tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "TableSnapshot.h"
+
+const uint32_t TableSnapshot::VERSION;
+const uint32_t TableSnapshot::BYTE_ORDER_MARK;
+
+/**
+ * Identification of the snapshot file.
+ */
+const static char SNAPSHOT_MAGIC[8] = {'L', 'P', 'M', 'T', 'R', 'I', 'E', '\0'};
+
+/**
+ * Node arrays are aligned to the page size, so they can be mapped on their own.
+ */
+const static uint64_t SECTION_ALIGNMENT = 4096;
+
+/**
+ * Writes whole data at the offset of the file.
+ * @param fd File descriptor.
+ * @param data Data which should be written.
+ * @param size Size of the data.
+ * @param offset Offset in the file.
+ * @return True if no error occurs, else false.
+ */
+static bool writeAll(int fd, const void *data, size_t size, uint64_t offset) {
+    const char *chars = static_cast<const char *>(data);
+
+    while (size != 0) {
+        ssize_t written = pwrite(fd, chars, size, offset);
+        if (written <= 0) {
+            return false;
+        }
+        chars += written;
+        size -= written;
+        offset += written;
+    }
+
+    return true;
+}
+
+/**
+ * Constructs snapshot without mapped file.
+ */
+TableSnapshot::TableSnapshot() : _data(0), _size(0)
+{
+}
+
+/**
+ * Destructor, unmaps the file. Tries must not use the snapshot anymore.
+ */
+TableSnapshot::~TableSnapshot()
+{
+    close();
+}
+
+/**
+ * Writes snapshot of the tries into file. File is replaced atomically,
+ * so the processes which map the old file are not affected.
+ * @param filename Filename of the snapshot.
+ * @param ipv4Trie Trie with IPv4 to ASN mapping.
+ * @param ipv6Trie Trie with IPv6 to ASN mapping.
+ * @return True if no error occurs, else false.
+ */
+bool TableSnapshot::write(const string &filename, const AddrTrieBase &ipv4Trie, const AddrTrieBase &ipv6Trie) {
+    const AddrTrieBase *tries[2] = {&ipv4Trie, &ipv6Trie};
+    SnapshotHeader header;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = VERSION;
+    header.byteOrder = BYTE_ORDER_MARK;
+    header.nodeSize = sizeof(TrieNode);
+    header.sectionCount = 2;
+
+    uint64_t offset = sizeof(header);
+    for (int i = 0; i < 2; i++) {
+        const NodePool<TrieNode> &nodes = tries[i]->getNodePool();
+        SnapshotSection &section = header.sections[i];
+
+        offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+        section.bitLength = (i == 0) ? 32 : 128;
+        section.nodeCount = nodes.size();
+        section.prefixCount = tries[i]->getPrefixCount();
+        section.offset = offset;
+        section.checksum = checksum(nodes.getNodes(), (size_t)nodes.size() * sizeof(TrieNode));
+
+        offset += (uint64_t)nodes.size() * sizeof(TrieNode);
+    }
+    header.checksum = checksum(&header, sizeof(header));
+
+    // New snapshot is written aside and renamed over the old one at the end
+    string tmpFilename = filename + ".tmp";
+    int fd = ::open(tmpFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        return false;
+    }
+
+    bool ok = writeAll(fd, &header, sizeof(header), 0);
+    for (int i = 0; ok && (i < 2); i++) {
+        const NodePool<TrieNode> &nodes = tries[i]->getNodePool();
+        ok = writeAll(fd, nodes.getNodes(), (size_t)nodes.size() * sizeof(TrieNode), header.sections[i].offset);
+    }
+
+    ok = (::close(fd) == 0) && ok;
+    if (!ok || (rename(tmpFilename.c_str(), filename.c_str()) == -1)) {
+        unlink(tmpFilename.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Maps the snapshot file and validates its header and bounds of the sections.
+ * Node arrays are not read, so opening does not depend on the size of the tables.
+ * @param filename Filename of the snapshot.
+ * @return True if the snapshot is valid, else false.
+ */
+bool TableSnapshot::open(const string &filename) {
+    close();
+
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat fileStat;
+    if ((fstat(fd, &fileStat) == -1) || ((size_t)fileStat.st_size < sizeof(SnapshotHeader))) {
+        ::close(fd);
+        return false;
+    }
+
+    void *mapped = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);                     // Mapping stays valid without the descriptor
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+    _data = mapped;
+    _size = fileStat.st_size;
+
+    /* Header has to match this build, sections are checked afterwards */
+    SnapshotHeader header;
+    memcpy(&header, _data, sizeof(header));
+    uint64_t headerChecksum = header.checksum;
+    header.checksum = 0;
+
+    bool valid = (memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) == 0)
+                 && (header.version == VERSION)
+                 && (header.byteOrder == BYTE_ORDER_MARK)
+                 && (header.nodeSize == sizeof(TrieNode))
+                 && (header.sectionCount == 2)
+                 && (checksum(&header, sizeof(header)) == headerChecksum)
+                 && (header.sections[0].bitLength == 32)
+                 && (header.sections[1].bitLength == 128)
+                 && validateSection(header.sections[0])
+                 && validateSection(header.sections[1]);
+
+    if (!valid) {
+        close();
+    }
+
+    return valid;
+}
+
+/**
+ * Verifies checksums and child indices of all nodes of the opened snapshot.
+ * @return True if the node arrays are intact, else false.
+ */
+bool TableSnapshot::verify() const {
+    const SnapshotHeader *header = static_cast<const SnapshotHeader *>(_data);
+
+    return (_data != 0) && verifySection(header->sections[0]) && verifySection(header->sections[1]);
+}
+
+/**
+ * Lets the tries serve lookups from the mapped node arrays.
+ * @param ipv4Trie Trie which gets IPv4 section.
+ * @param ipv6Trie Trie which gets IPv6 section.
+ */
+void TableSnapshot::attach(AddrTrieBase &ipv4Trie, AddrTrieBase &ipv6Trie) const {
+    const SnapshotHeader *header = static_cast<const SnapshotHeader *>(_data);
+    AddrTrieBase *tries[2] = {&ipv4Trie, &ipv6Trie};
+
+    for (int i = 0; i < 2; i++) {
+        const SnapshotSection &section = header->sections[i];
+        const TrieNode *nodes = reinterpret_cast<const TrieNode *>(static_cast<const char *>(_data) + section.offset);
+        tries[i]->attachNodes(nodes, section.nodeCount, section.prefixCount);
+    }
+}
+
+/**
+ * Unmaps the snapshot file.
+ */
+void TableSnapshot::close() {
+    if (_data != 0) {
+        munmap(_data, _size);
+    }
+    _data = 0;
+    _size = 0;
+}
+
+/**
+ * Computes checksum of the data (Fletcher like sums of the 32 bit words).
+ * @param data Data whose checksum should be computed.
+ * @param size Size of the data, multiple of 4 bytes.
+ * @return Checksum of the data.
+ */
+uint64_t TableSnapshot::checksum(const void *data, size_t size) {
+    const uint32_t *words = static_cast<const uint32_t *>(data);
+    uint64_t sum1 = 0;
+    uint64_t sum2 = 0;
+
+    for (size_t i = 0; i < size / 4; i++) {
+        sum1 += words[i];
+        sum2 += sum1;
+    }
+
+    return (sum2 << 32) ^ sum1 ^ (sum2 >> 32);
+}
+
+/**
+ * Validates that the section lies inside the mapped file.
+ * @param section Section which should be validated.
+ * @return True if the section is valid, else false.
+ */
+bool TableSnapshot::validateSection(const SnapshotSection &section) const {
+    size_t bytes = (size_t)section.nodeCount * sizeof(TrieNode);
+
+    return (section.nodeCount != 0) && (section.offset % SECTION_ALIGNMENT == 0)
+           && (section.offset <= _size) && (bytes <= _size - section.offset);
+}
+
+/**
+ * Verifies checksum and child indices of the nodes of the section.
+ * @param section Section which should be verified, validated by open().
+ * @return True if the nodes are intact, else false.
+ */
+bool TableSnapshot::verifySection(const SnapshotSection &section) const {
+    size_t bytes = (size_t)section.nodeCount * sizeof(TrieNode);
+    const TrieNode *nodes = reinterpret_cast<const TrieNode *>(static_cast<const char *>(_data) + section.offset);
+
+    if (checksum(nodes, bytes) != section.checksum) {
+        return false;
+    }
+
+    /* Children have to be inside the array, lookups then never leave it */
+    for (uint32_t i = 0; i < section.nodeCount; i++) {
+        if ((nodes[i].getLeftChild() >= section.nodeCount) || (nodes[i].getRightChild() >= section.nodeCount)) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       TableSnapshot.h
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Header file which defines binary snapshot of the compiled tables.
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file TableSnapshot.h
+ *
+ * @brief Defines binary snapshot of the compiled tables.
+ * @author Longest-Prefix Match contributors
+ */
+
+#ifndef TABLESNAPSHOT_H
+#define TABLESNAPSHOT_H
+
+#include <stdint.h>
+
+#include <string>
+
+#include "AddrTrieBase.h"
+
+using namespace std;
+
+/**
+ * Section of the snapshot with the node array of one bit trie.
+ */
+struct SnapshotSection {
+    uint32_t bitLength;     /**< Length of the addresses of the trie (32 or 128) */
+    uint32_t nodeCount;     /**< Number of the nodes, root is the first one */
+    uint64_t prefixCount;   /**< Number of the stored prefixes */
+    uint64_t offset;        /**< Offset of the node array from the beginning of the file */
+    uint64_t checksum;      /**< Checksum of the node array */
+};
+
+/**
+ * Header at the beginning of the snapshot file.
+ */
+struct SnapshotHeader {
+    char magic[8];          /**< Identification of the file */
+    uint32_t version;       /**< Version of the format */
+    uint32_t byteOrder;     /**< BYTE_ORDER_MARK written in the byte order of the writer */
+    uint32_t nodeSize;      /**< Size of the node */
+    uint32_t sectionCount;  /**< Number of the used sections */
+    SnapshotSection sections[2]; /**< Sections of the IPv4 and IPv6 tries */
+    uint64_t checksum;      /**< Checksum of the header, computed with this field zeroed */
+};
+
+/**
+ * Binary snapshot of the compiled IPv4 and IPv6 bit tries. Nodes reference
+ * their children by index, so the node arrays are position independent and
+ * tries are served directly from the mapped file without deserialization.
+ * Mapping is shared by all processes which use the same snapshot. Opening
+ * checks only the header, nodes of the file damaged after writing are
+ * detected by verify().
+ */
+class TableSnapshot
+{
+public:
+    /**
+     * Constructs snapshot without mapped file.
+     */
+    TableSnapshot();
+
+    /**
+     * Destructor, unmaps the file. Tries must not use the snapshot anymore.
+     */
+    ~TableSnapshot();
+
+    /**
+     * Writes snapshot of the tries into file. File is replaced atomically,
+     * so the processes which map the old file are not affected.
+     * @param filename Filename of the snapshot.
+     * @param ipv4Trie Trie with IPv4 to ASN mapping.
+     * @param ipv6Trie Trie with IPv6 to ASN mapping.
+     * @return True if no error occurs, else false.
+     */
+    static bool write(const string &filename, const AddrTrieBase &ipv4Trie, const AddrTrieBase &ipv6Trie);
+
+    /**
+     * Maps the snapshot file and validates its header and bounds of the sections.
+     * Node arrays are not read, so opening does not depend on the size of the tables.
+     * @param filename Filename of the snapshot.
+     * @return True if the snapshot is valid, else false.
+     */
+    bool open(const string &filename);
+
+    /**
+     * Verifies checksums and child indices of all nodes of the opened snapshot.
+     * @return True if the node arrays are intact, else false.
+     */
+    bool verify() const;
+
+    /**
+     * Lets the tries serve lookups from the mapped node arrays.
+     * @param ipv4Trie Trie which gets IPv4 section.
+     * @param ipv6Trie Trie which gets IPv6 section.
+     */
+    void attach(AddrTrieBase &ipv4Trie, AddrTrieBase &ipv6Trie) const;
+
+    /**
+     * Unmaps the snapshot file.
+     */
+    void close();
+
+    const static uint32_t VERSION = 1;                /**< Version of the format */
+    const static uint32_t BYTE_ORDER_MARK = 0x01020304; /**< Detects snapshot of other byte order */
+
+private:
+    void *_data;            /**< Mapped file */
+    size_t _size;           /**< Size of the mapped file */
+
+    /**
+     * Computes checksum of the data (Fletcher like sums of the 32 bit words).
+     * @param data Data whose checksum should be computed.
+     * @param size Size of the data, multiple of 4 bytes.
+     * @return Checksum of the data.
+     */
+    static uint64_t checksum(const void *data, size_t size);
+
+    /**
+     * Validates that the section lies inside the mapped file.
+     * @param section Section which should be validated.
+     * @return True if the section is valid, else false.
+     */
+    bool validateSection(const SnapshotSection &section) const;
+
+    /**
+     * Verifies checksum and child indices of the nodes of the section.
+     * @param section Section which should be verified, validated by open().
+     * @return True if the nodes are intact, else false.
+     */
+    bool verifySection(const SnapshotSection &section) const;
+
+    TableSnapshot(const TableSnapshot &);
+    TableSnapshot &operator=(const TableSnapshot &);
+};
+
+#endif // TABLESNAPSHOT_H
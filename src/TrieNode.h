@@ -20,62 +20,83 @@
 #ifndef TRIENODE_H
 #define TRIENODE_H
 
+#include <stdint.h>
+
+/**
+ * Node of the bit trie. Nodes are stored in the pool and children are
+ * referenced by their index in the pool, index 0 (root) means no child.
+ * Children and value are accessed atomically, child is stored with release
+ * ordering after the child node has been initialized and loaded with acquire
+ * ordering, so readers walk the trie while single writer links new nodes and
+ * always see them initialized. Both are plain moves on x86.
+ */
 class TrieNode
 {
 public:
 	/**
 	 * Constructs an empty trie node.
 	 */
-	TrieNode() : _leftChild(0), _rightChild(0), _value(0) {}
+	TrieNode() : _value(0) {
+	    _children[0] = 0;
+	    _children[1] = 0;
+	}
 
 	/**
 	 * Constructs trie node with specified children and value.
 	 * @param value Value which will have this node.
-	 * @param leftChild Pointer to left child of this node.
-	 * @param rightChild Pointer to right child of this node.
+	 * @param leftChild Index of left child of this node.
+	 * @param rightChild Index of right child of this node.
 	 */
-	TrieNode(void *value, TrieNode *leftChild, TrieNode *rightChild)
-	: _leftChild(leftChild), _rightChild(rightChild), _value(value) {}
+	TrieNode(uint32_t value, uint32_t leftChild, uint32_t rightChild) : _value(value) {
+	    _children[0] = leftChild;
+	    _children[1] = rightChild;
+	}
 
 	/**
 	 * Sets left child of this node.
-	 * @param child New child will be set as a left child in this node.
+	 * @param child Index of the new child will be set as a left child in this node.
 	 */
-    inline void setLeftChild(TrieNode *child) { _leftChild = child; }
+    inline void setLeftChild(uint32_t child) { __atomic_store_n(&_children[0], child, __ATOMIC_RELEASE); }
 
 	/**
 	 * Gets left child of this node.
-	 * @param Light child of this node.
+	 * @param Index of left child of this node.
 	 */
-    inline TrieNode *getLeftChild() { return _leftChild; }
+    inline uint32_t getLeftChild() const { return __atomic_load_n(&_children[0], __ATOMIC_ACQUIRE); }
 
 	/**
 	 * Sets right child of this node.
-	 * @param child New child will be set as a right child in this node.
+	 * @param child Index of the new child will be set as a right child in this node.
 	 */
-    inline void setRightChild(TrieNode *child) { _rightChild = child; }
+    inline void setRightChild(uint32_t child) { __atomic_store_n(&_children[1], child, __ATOMIC_RELEASE); }
 
 	/**
 	 * Gets right child of this node.
-	 * @param Right child of this node.
+	 * @param Index of right child of this node.
+	 */
+    inline uint32_t getRightChild() const { return __atomic_load_n(&_children[1], __ATOMIC_ACQUIRE); }
+
+	/**
+	 * Gets child of this node selected by the bit, lookups select it without branch.
+	 * @param bit 0 for left child, 1 for right child.
+	 * @return Index of the child of this node.
 	 */
-    inline TrieNode *getRightChild() { return _rightChild; }
+    inline uint32_t getChild(int bit) const { return __atomic_load_n(&_children[bit], __ATOMIC_ACQUIRE); }
 
 	/**
 	 * Sets new value to this node.
 	 * @param value Value to be set.
 	 */
-    inline void setValue(void *value) { _value = value; }
+    inline void setValue(uint32_t value) { __atomic_store_n(&_value, value, __ATOMIC_RELAXED); }
 
     /**
      * Returns value of this node.
      * @return Value of this node.
      */
-    inline void *getValue() { return _value; }
+    inline uint32_t getValue() const { return __atomic_load_n(&_value, __ATOMIC_RELAXED); }
 private:
-    TrieNode *_leftChild;       /**< Left child node */
-    TrieNode *_rightChild;      /**< Right child node */
-    void *_value;               /**< Value of this node */
+    uint32_t _children[2];      /**< Indices of left and right child node */
+    uint32_t _value;            /**< Value of this node (ASN), 0 means no value */
 };
 
 #endif // TRIENODE_H
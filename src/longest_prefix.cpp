@@ -25,12 +25,23 @@
 #include <cstdio>
 #include <cstring>
 
+#include <getopt.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>         
 
 #include "AddrTrie.h"
+#include "BinarySearcher.h"
+#include "LineSearcher.h"
+#include "LookupServer.h"
+#include "OutputBuffer.h"
+#include "RouteUpdater.h"
+#include "RuntimeStats.h"
+#include "SearchPipeline.h"
+#include "TableLoader.h"
+#include "TableReloader.h"
+#include "TableSnapshot.h"
 
 using namespace std;
 
@@ -38,7 +49,25 @@ using namespace std;
  * Enumeration of the flags which accepts this program
  */
 enum flags {
-    ASN_FILE = 'i'     /**< Input file with AS numbers */
+    ASN_FILE = 'i',      /**< Input file with AS numbers */
+    IPV4_ENGINE = '4',   /**< Lookup engine used for IPv4 addresses */
+    IPV6_ENGINE = '6',   /**< Lookup engine used for IPv6 addresses */
+    BUILD_THREADS = 'b', /**< Number of the threads which build the tables */
+    THREADS = 'j',       /**< Number of the searching threads */
+    COMPILE = 'C',       /**< File with AS numbers compiled into snapshot (--compile only) */
+    OUTPUT_FILE = 'o',   /**< Output file of the compiled snapshot */
+    TABLE_FILE = 't',    /**< Snapshot file with compiled tables */
+    VERIFY = 'V',        /**< Verify all nodes of the snapshot (--verify only) */
+    RELOAD = 'r',        /**< Reload tables on SIGHUP or when the file changes */
+    UPDATES = 'd',       /**< Apply update lines of the stdin to the tables */
+    UPDATE_FILE = 'u',   /**< File with update lines applied by updater thread */
+    LISTEN = 'L',        /**< Socket where lookups are served (--listen only) */
+    CACHE = 'c',         /**< Number of the addresses cached by each searching thread */
+    AGGREGATE = 'a',     /**< Replace loaded prefixes by the smallest set with the same results */
+    STATS = 'S',         /**< Print runtime statistics as JSON on stderr (--stats only) */
+    BINARY_INPUT = 'B',  /**< Stdin holds binary frames of the addresses (--binary-input only) */
+    BINARY_OUTPUT = 'O', /**< Print ASNs as packed 32 bit numbers (--binary-output only) */
+    VERBOSE = 'v'        /**< Print statistics about the tables */
            };
 
 enum errors {
@@ -56,21 +85,100 @@ const string MSG_ERR_FILE_OPEN =
 const string MSG_WRN_MISSING_ARGUMENT =
         "Warning: Missing argument to option flag: ";
 const string MSG_ERR_STDOUT_IO = "Error: Unable to write on stdout!";
+const string MSG_ERR_UNKNOWN_ENGINE =
+        "Error: Unknown lookup engine or invalid engine parameters: ";
+const string MSG_ERR_INVALID_THREADS = "Error: Invalid number of the threads: ";
+const string MSG_ERR_NO_OUTPUT_FILE = "Error: No output file for the compiled snapshot specified!";
+const string MSG_ERR_SNAPSHOT_ENGINE = "Error: Snapshots are supported only by the bit engine!";
+const string MSG_ERR_SNAPSHOT_OPEN = "Error: Unable to open snapshot or snapshot is not valid: ";
+const string MSG_ERR_SNAPSHOT_VERIFY = "Error: Snapshot is damaged: ";
+const string MSG_ERR_SNAPSHOT_WRITE = "Error: Unable to write snapshot: ";
+const string MSG_ERR_RELOAD_THREAD = "Error: Unable to start reloading of the tables!";
+const string MSG_ERR_UPDATE_ENGINE = "Error: Updates are supported only by the bit engine!";
+const string MSG_ERR_UPDATE_THREADS = "Error: Updates cannot be applied with more searching threads!";
+const string MSG_ERR_UPDATE_FILE = "Error: Unable to open file with updates: ";
+const string MSG_ERR_UPDATE_SOURCES = "Error: Updates can be read either from stdin or from file!";
+const string MSG_ERR_LISTEN_OPTIONS = "Error: Server mode cannot be combined with -d, -j or -c!";
+const string MSG_ERR_LISTEN = "Error: Unable to listen on socket: ";
+const string MSG_ERR_SERVE = "Error: Serving of the connections has failed!";
+const string MSG_ERR_INVALID_CACHE = "Error: Invalid size of the cache: ";
+const string MSG_ERR_BINARY_OPTIONS = "Error: Binary input cannot be combined with -d, -j, -c or --listen!";
+const string MSG_ERR_BINARY_INPUT = "Error: Binary input is malformed or truncated!";
+const string MSG_ERR_AGGREGATE_OPTIONS = "Error: Aggregated tables cannot be mapped from snapshot or updated!";
+
+/**
+ * Maximal number of the searching threads.
+ */
+const static int MAX_THREADS = 256;
+
+/**
+ * Maximal number of the addresses cached by one searching thread.
+ */
+const static long MAX_CACHE_ENTRIES = 1L << 26;
+
+/**
+ * Names of the lookup engines which can be selected for the address families.
+ */
+const string ENGINE_BIT = "bit";
+const string ENGINE_MULTIBIT = "multibit";
+const string ENGINE_DIR248 = "dir248";
+const string ENGINE_LENGTHS = "lengths";
+const string ENGINE_POPTRIE = "poptrie";
+const string ENGINE_PATRICIA = "patricia";
+const string ENGINE_LEAFPUSH = "leafpush";
 
 /**
  * Help message which will be printed on stdout when error occurs.
  */
 const string HELP = "PDS - Longest prefix match\n"
                     "Použití:\n"
-                    "  \tlpm -i <název_asn_souboru>\n"
+                    "  \tlpm -i <název_asn_souboru> [-4 <engine>] [-6 <engine>] [-a] [-b <vlákna>] [-j <vlákna>] [-c <adresy>] [-r] [-d | -u <soubor>] [-v] [--stats] [--binary-output]\n"
+                    "  \tlpm (-i <název_asn_souboru> | -t <snapshot> [--verify]) --binary-input [-r] [-u <soubor>] [-v] [--stats] [--binary-output]\n"
+                    "  \tlpm --compile <název_asn_souboru> -o <snapshot> [-a] [-b <vlákna>] [-v]\n"
+                    "  \tlpm -t <snapshot> [--verify] [-j <vlákna>] [-c <adresy>] [-r] [-d | -u <soubor>] [-v] [--stats] [--binary-output]\n"
+                    "  \tlpm (-i <název_asn_souboru> | -t <snapshot> [--verify]) --listen <soket> [-r] [-u <soubor>] [-v] [--stats]\n"
                     "\n"
                     "Přepínače:\n"
-                    "-i\t- název souboru s AS záznamy pro IP adresy";
+                    "-i\t- název souboru s AS záznamy pro IP adresy\n"
+                    "-4\t- vyhledávací engine pro IPv4 adresy (bit, multibit[:<kroky>], dir248, patricia, lengths, poptrie, leafpush)\n"
+                    "-6\t- vyhledávací engine pro IPv6 adresy (bit, multibit[:<kroky>], patricia, lengths, poptrie, leafpush)\n"
+                    "-a\t- prefixy se před stavbou tabulek nahradí nejmenší množinou se stejnými výsledky (ORTC),\n"
+                    "\t  počty prefixů a paměť bitového stromu před a po se vypíší na standardní chybový výstup\n"
+                    "-b\t- počet vláken pro načtení a stavbu tabulek (výchozí 1)\n"
+                    "-j\t- počet vláken pro vyhledávání, výstup zachovává pořadí vstupu (výchozí 1)\n"
+                    "-c\t- každé vyhledávací vlákno si pamatuje výsledky až pro zadaný počet adres od každé rodiny\n"
+                    "--compile\t- zkompiluje AS záznamy do binárního snapshotu tabulek (engine bit)\n"
+                    "-o\t- název souboru, do kterého se zapíše snapshot\n"
+                    "-t\t- tabulky se namapují z předem zkompilovaného snapshotu, ověří se jen jeho hlavička\n"
+                    "--verify\t- před použitím snapshotu se ověří kontrolní součty a indexy všech uzlů\n"
+                    "-r\t- tabulky se znovu načtou na SIGHUP nebo po změně souboru, vyhledávání běží dál\n"
+                    "-d\t- řádky \"+prefix asn\" a \"-prefix\" na vstupu přidají/změní a odeberou prefix v tabulkách\n"
+                    "-u\t- soubor (např. roura), ze kterého vlákno aplikuje řádky \"+prefix asn\" a \"-prefix\" za běhu vyhledávání\n"
+                    "--binary-input\t- vstup obsahuje binární rámce jako protokol serveru: 32 bitová hlavička v síťovém pořadí\n"
+                    "\t  (horních 8 bitů rodina 4 nebo 6, dolních 24 bitů počet adres) a za ní adresy po 4 nebo 16 bajtech\n"
+                    "--binary-output\t- každé ASN se vypíše jako 32 bitové číslo v síťovém pořadí, 0 znamená žádnou shodu\n"
+                    "--listen\t- dotazy se obsluhují na Unix soketu (cesta obsahuje '/') nebo TCP portu [<host>:]<port>\n"
+                    "-v\t- vypíše statistiky o tabulkách na standardní chybový výstup\n"
+                    "--stats\t- na konci vypíše tvar tabulek a čítače vyhledávání jako JSON na standardní chybový výstup\n"
+                    "\t  (čítače jen při překladu s -DLPM_STATS, make stats)";
 
 /**
  * Filter/Mask string for getopt function.
  */
-static const string GETOPT_STRING = "i:";
+static const string GETOPT_STRING = "i:4:6:b:j:o:t:u:c:ardv";
+
+/**
+ * Long options for getopt_long function.
+ */
+static const struct option LONG_OPTIONS[] = {
+    {"compile", required_argument, NULL, COMPILE},
+    {"listen", required_argument, NULL, LISTEN},
+    {"stats", no_argument, NULL, STATS},
+    {"verify", no_argument, NULL, VERIFY},
+    {"binary-input", no_argument, NULL, BINARY_INPUT},
+    {"binary-output", no_argument, NULL, BINARY_OUTPUT},
+    {NULL, 0, NULL, 0}
+};
 
 /**
  * Read block buffer for IO operations.
@@ -79,15 +187,9 @@ const static int RBUFFER_SIZE = 65536;
 static char block_rbuffer[RBUFFER_SIZE] = {0};
 
 /**
- * Write block buffer for IO operations.
+ * Write block buffer size for IO operations.
  */
 const static int WBUFFER_SIZE = 65536;
-static char block_wbuffer[WBUFFER_SIZE] = {0};
-
-/**
-  * Length of the line which is accepted during IO operations.
-  */
-const static int MAX_LINE_LENGTH = 512;
 
 /**
  * Gets flags and arguments ryped on command line.
@@ -101,13 +203,34 @@ map<char, string> &getFlags(int argc, char **argv, map<char, string> &flags) {
 
     opterr = 0;
     // Processing cmd line parameters
-    while ((ch = getopt(argc, argv, GETOPT_STRING.c_str())) != -1) {
+    while ((ch = getopt_long(argc, argv, GETOPT_STRING.c_str(), LONG_OPTIONS, NULL)) != -1) {
         switch (ch) {
             // known parameter
         case ASN_FILE:
+        case IPV4_ENGINE:
+        case IPV6_ENGINE:
+        case THREADS:
+        case BUILD_THREADS:
+        case COMPILE:
+        case OUTPUT_FILE:
+        case TABLE_FILE:
+        case UPDATE_FILE:
+        case LISTEN:
+        case CACHE:
             optargString = (!optarg) ? string() : optarg; // getting argument whether has
             flags.insert(pair<char, string>(ch, optargString)); // storing to map array
             break;
+            // known flag without argument
+        case AGGREGATE:
+        case RELOAD:
+        case UPDATES:
+        case VERBOSE:
+        case STATS:
+        case VERIFY:
+        case BINARY_INPUT:
+        case BINARY_OUTPUT:
+            flags.insert(pair<char, string>(ch, string()));
+            break;
             // unknown flag
         case '?':
             cerr << MSG_WRN_UNKNOWN_OPTION << char(optopt) << endl;
@@ -132,195 +255,330 @@ map<char, string> &getFlags(int argc, char **argv, map<char, string> &flags) {
 }
 
 /**
-  * Rebuilds ASN buffer from specified position where each item of ASN record were delimited by '\0'
-  * @param fromPosition Position from where should be buffer restored
-  */
-inline void rebuildASNBuffer(char *fromPosition) {
-    char *buffEnd = &block_rbuffer[RBUFFER_SIZE - 1];
-    char *buffChar = fromPosition;
-    int state = 0;
-    while (buffChar != buffEnd) {
-        if (*buffChar == '\0') {
-            switch (state) {
-            case 0:
-                *buffChar = '/';
-                break;
-            case 1:
-                *buffChar = ' ';
-                break;
-            case 2:
-                *buffChar = '\n';
-                state = 0;
-                break;
-            }
-            state++;
+ * Creates lookup engine for the specified address family.
+ * @param spec Name of the engine optionally followed by ':' and engine parameters (e.g. "multibit:16,8,8").
+ * @return New lookup engine or NULL if the engine is unknown or parameters are invalid.
+ */
+template<class AddrFamily>
+AddrLookupBase *createLookupEngine(const string &spec) {
+    size_t delim = spec.find(':');
+    string name = spec.substr(0, delim);
+    string param = (delim == string::npos) ? string() : spec.substr(delim + 1);
+
+    if (name == ENGINE_BIT && param.empty()) {
+        return new AddrTrie<AddrFamily>();
+    } else if (name == ENGINE_MULTIBIT) {
+        AddrTrie<AddrFamily, MultibitTrieBase> *trie = new AddrTrie<AddrFamily, MultibitTrieBase>();
+        if (!param.empty() && !trie->setStrides(param.c_str())) {
+            delete trie;
+            return NULL;
         }
-        buffChar++;
+        return trie;
+    } else if (name == ENGINE_PATRICIA && param.empty()) {
+        return new AddrTrie<AddrFamily, PatriciaTrieBase>();
+    } else if (name == ENGINE_DIR248 && param.empty() && sizeof(typename AddrFamily::Addr) == sizeof(uint32_t)) {
+        return new AddrTrie<AddrFamily, Dir248Table>();
+    } else if (name == ENGINE_LENGTHS && param.empty()) {
+        return new AddrTrie<AddrFamily, LengthSearchTable>();
+    } else if (name == ENGINE_POPTRIE && param.empty()) {
+        return new AddrTrie<AddrFamily, PoptrieBase>();
+    } else if (name == ENGINE_LEAFPUSH && param.empty()) {
+        return new AddrTrie<AddrFamily, LeafPushedTrieBase>();
     }
+
+    return NULL;
 }
 
 /**
- * Fastly loads numbers of autonomous systems into IPv4 and IPv6 tries.
- * @param filename Filename of the file with AS numbers.
- * @param ipv4Trie Trie where IPv4 to ASN mapping will be stored.
- * @param ipv6Trie Trie where IPv6 to ASN mapping will be stored.
+ * Prints statistics about the content and memory usage of the table on stderr.
+ * @param title Title of the table.
+ * @param table Table whose statistics should be printed.
  */
-bool loadTrieFromFile(const string &filename,
-                      AddrTrie<IPv4AddrFamily> &ipv4Trie,
-                      AddrTrie<IPv6AddrFamily> &ipv6Trie) {
-
-    int asnFile = open(filename.c_str(), O_RDONLY);
-    if (asnFile == -1) {
-        return false;
+void printTableStats(const string &title, const AddrLookupBase &table) {
+    LookupStats stats;
+    table.getStats(stats);
+
+    cerr << title << ": prefixes " << stats.prefixes
+         << ", nodes " << stats.nodes
+         << ", memory " << stats.bytes << " B";
+    if (stats.uncompressedNodes != 0) {  // Compressing engine, show the gain
+        cerr << " (uncompressed nodes " << stats.uncompressedNodes
+             << ", memory " << stats.uncompressedBytes << " B)";
     }
+    cerr << endl;
+}
 
-    char empty_str[1] = {'\0'};
+/**
+ * Prints number of the prefixes and memory of the used nodes of the bit trie before and after aggregation on stderr.
+ * @param title Title of the table.
+ * @param before Statistics of the loaded prefixes.
+ * @param after Statistics of the aggregated prefixes.
+ */
+void printAggregationStats(const string &title, const LookupStats &before, const LookupStats &after) {
+    cerr << title << ": prefixes " << before.prefixes << " -> " << after.prefixes
+         << ", nodes " << before.nodes << " -> " << after.nodes
+         << ", memory " << before.nodes * sizeof(TrieNode) << " B -> " << after.nodes * sizeof(TrieNode) << " B" << endl;
+}
 
-    char *buffEnd = &block_rbuffer[RBUFFER_SIZE - 1];
-    ssize_t read_bytes = 0;
-    size_t head_bytes = 0;
-    size_t tail_bytes = 1;
-    size_t buff_size = RBUFFER_SIZE - tail_bytes - head_bytes;
-    while ((read_bytes = read(asnFile, &block_rbuffer[head_bytes], buff_size)) > 0) {
+/**
+ * Options of building the tables.
+ */
+struct TableOptions {
+    string ipv4Engine;          /**< Lookup engine for IPv4 addresses */
+    string ipv6Engine;          /**< Lookup engine for IPv6 addresses */
+    string asnFilename;         /**< File with AS numbers */
+    string snapshotFilename;    /**< Snapshot file, used instead of the file with AS numbers if not empty */
+    int buildThreads;           /**< Number of the threads which build the tables */
+    bool verify;                /**< Verify all nodes of the snapshot */
+    bool aggregate;             /**< Aggregate the loaded prefixes */
+    bool verbose;               /**< Print statistics about the tables */
+    RcuDomain *rcu;             /**< Domain of the readers when the tables are updated concurrently, or NULL */
+    int error;                  /**< Error code of the last failed building */
+};
 
-        block_rbuffer[head_bytes + read_bytes] = '\0'; // Make string from the mapped array
+/**
+ * Builds tables from the file with AS numbers or maps them from the snapshot.
+ * Errors are printed on stderr, this is also used by reload thread.
+ * @param optionsPtr Options of building the tables.
+ * @return New tables or NULL if error occurs.
+ */
+TableSet *loadTables(void *optionsPtr) {
+    TableOptions &options = *static_cast<TableOptions *>(optionsPtr);
+    TableSet *tables = new TableSet();
+
+    /* Create lookup engines for both address families. */
+    tables->ipv4 = createLookupEngine<IPv4AddrFamily>(options.ipv4Engine);
+    if (tables->ipv4 == NULL) {
+        cerr << MSG_ERR_UNKNOWN_ENGINE << options.ipv4Engine << endl;
+        options.error = ERR_ARGUMENTS;
+        delete tables;
+        return NULL;
+    }
 
-        char *ipChars = block_rbuffer; // Start pointer address of IP address is identical with the start of the block
-        char *prefixChars = empty_str;
-        char *asnChars = empty_str;
-        char *buffChar = block_rbuffer; // Set pointer to char which we will iterate
-        int prefix = 0;
-
-        AddrTrieBase *currTrie = &ipv4Trie;
-
-        // Parsing loop
-        while (*buffChar != '\0') {
-            switch (*buffChar) {
-            case '/': // Begin of processing prefix number
-                prefixChars = buffChar + 1;
-                *buffChar = '\0'; // We ended parsing of the IP address
-                break;
-            case ' ': // Begin of processing ASN
-                asnChars = buffChar + 1;
-                *buffChar = '\0'; // We ended parsing of the prefix
-                break;
-            case '\n': // End of string, so end of parsing
-                *buffChar = '\0'; // We ended parsing of the prefix
-
-                /* Convert prefix number and ASN into numerical representation */
-                prefix = atoi(prefixChars);
-
-                // Insert new record into trie
-                currTrie->insertASN(ipChars, prefix, asnChars);
-
-                ipChars = buffChar + 1;
-                currTrie = &ipv4Trie;
-                break;
-            case ':': // We are processing IPv6 address, so set IPv6 trie
-                currTrie = &ipv6Trie;
-                break;
-            }
-            buffChar++; // Move on next character
+    tables->ipv6 = createLookupEngine<IPv6AddrFamily>(options.ipv6Engine);
+    if (tables->ipv6 == NULL) {
+        cerr << MSG_ERR_UNKNOWN_ENGINE << options.ipv6Engine << endl;
+        options.error = ERR_ARGUMENTS;
+        delete tables;
+        return NULL;
+    }
+
+    LPM_STATS_START(start);
+    if (!options.snapshotFilename.empty()) {
+        /* Map compiled tables from the snapshot. */
+        tables->snapshot = new TableSnapshot();
+        if (!tables->snapshot->open(options.snapshotFilename)) {
+            cerr << MSG_ERR_SNAPSHOT_OPEN << options.snapshotFilename << endl;
+            options.error = ERR_FILE;
+            delete tables;
+            return NULL;
+        }
+        if (options.verify && !tables->snapshot->verify()) {
+            cerr << MSG_ERR_SNAPSHOT_VERIFY << options.snapshotFilename << endl;
+            options.error = ERR_FILE;
+            delete tables;
+            return NULL;
+        }
+        tables->snapshot->attach(*static_cast<AddrTrieBase *>(tables->ipv4), *static_cast<AddrTrieBase *>(tables->ipv6));
+    } else {
+        /* Load AS numbers from the file. */
+        TableLoader loader(*tables->ipv4, *tables->ipv6, options.aggregate);
+        if (!loader.load(options.asnFilename, options.buildThreads)) {
+            cerr << MSG_ERR_FILE_OPEN << endl;
+            options.error = ERR_FILE;
+            delete tables;
+            return NULL;
         }
 
-        rebuildASNBuffer(ipChars);
+        if (options.aggregate) {
+            printAggregationStats("IPv4 aggregation", loader.getStatsBefore(0), loader.getStatsAfter(0));
+            printAggregationStats("IPv6 aggregation", loader.getStatsBefore(1), loader.getStatsAfter(1));
+        }
+    }
 
-        head_bytes = strlen(ipChars);
-        memmove(block_rbuffer, ipChars, buffEnd - ipChars);
+    LPM_STATS_PHASE(PHASE_LOAD, start);
+    RuntimeStats::merge();      // Tables could be loaded by the reload thread
 
-        buff_size = RBUFFER_SIZE - tail_bytes - head_bytes;
+    // Updater thread modifies the tries while they are searched
+    if (options.rcu != NULL) {
+        static_cast<AddrTrieBase *>(tables->ipv4)->setReclaimDomain(options.rcu);
+        static_cast<AddrTrieBase *>(tables->ipv6)->setReclaimDomain(options.rcu);
     }
 
-    close(asnFile);
-    return read_bytes != -1;
+    if (options.verbose) {
+        printTableStats("IPv4 table (" + options.ipv4Engine + ")", *tables->ipv4);
+        printTableStats("IPv6 table (" + options.ipv6Engine + ")", *tables->ipv6);
+    }
+
+    return tables;
 }
 
 /**
-  * Flushes IO block buffer.
-  * @param fd File descriptor where should be buffer written.
-  * @param toPosition Position to which should be buffer flushed.
-  */
-inline bool flushBuffer(int fd, char *toPosition) {
-    return write(fd, block_wbuffer, toPosition - block_wbuffer) != -1;
+ * Prints hits and misses of the lookup caches on stderr.
+ * @param hits Number of the addresses answered from the caches.
+ * @param misses Number of the addresses searched in the tables.
+ */
+void printCacheStats(size_t hits, size_t misses) {
+    size_t total = hits + misses;
+
+    cerr << "Cache hits: " << hits << ", misses: " << misses;
+    if (total != 0) {
+        cerr << " (hit rate " << hits * 100 / total << " %)";
+    }
+    cerr << endl;
 }
 
 /**
  * Performs searching of the IP addresses which are put on the stdin.
- * @param ipv4Trie Searching trie for IPv4 addresses.
- * @param ipv6Trie Searching trie for IPv6 addresses.
+ * @param tables Holder of the searched tables.
+ * @param updates Apply update lines of the stdin to the tables.
+ * @param cacheEntries Number of the cached addresses of each family, 0 disables the cache.
+ * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
  */
-bool performSearching(AddrTrie<IPv4AddrFamily> &ipv4Trie,
-                      AddrTrie<IPv6AddrFamily> &ipv6Trie) {
+bool performSearching(TableReloader &tables, bool updates, size_t cacheEntries, bool binaryOutput) {
 
-    char *wbuffChar = block_wbuffer;
-    char *wbuffEnd = &block_wbuffer[RBUFFER_SIZE - 1];
-    *wbuffEnd = '\0';
+    LineSearcher searcher(updates, cacheEntries, binaryOutput);
+    OutputBuffer output(WBUFFER_SIZE, STDOUT_FILENO);
+    RcuReader *reader = tables.registerReader();
+    bool ok = true;
 
     ssize_t read_bytes = 0;
     size_t head_bytes = 0;
     size_t tail_bytes = 1;
     size_t buff_size = RBUFFER_SIZE - tail_bytes - head_bytes;
-    while ((read_bytes = read(STDIN_FILENO, &block_rbuffer[head_bytes], buff_size)) > 0) {
+    LPM_STATS_START(start);
+    while (ok && (read_bytes = read(STDIN_FILENO, &block_rbuffer[head_bytes], buff_size)) > 0) {
 
+        LPM_STATS_PHASE(PHASE_READ, start);
         block_rbuffer[head_bytes + read_bytes] = '\0'; // Make string from the mapped array
 
-        char *lineChars = block_rbuffer; // Start pointer address of IP address is identical with the start of the block
-        char *buffChar = block_rbuffer; // Set pointer to char which we will iterate
-
-        // Parsing loop
-        while (*buffChar != '\0') {
-            AddrTrieBase *currTrie = &ipv4Trie;
-
-            /* Remove new line character on the address string */
-            while (*buffChar != '\n') {
-                switch (*buffChar) {
-                case ':':
-                    currTrie = &ipv6Trie;
-                    break;
-                case '\0':
-                    goto end_outerloop;
-                }
-                buffChar++;
-            }
-            *buffChar = '\0';
-
-            char *matched = currTrie->longestPrefixMatch(lineChars);
-
-            if (matched == NULL) {     // No match found, print -
-                *wbuffChar++ = '-';
-                *wbuffChar++ = '\n';
-            } else {               // Match found, print corresponding ASN into write buffer
-                while (*matched != '\0') {
-                    *wbuffChar++ = *matched++;
-                }
-                *wbuffChar++ = '\n';
-            }
+        // Tables are held only while the block is searched, reload waits at most for one block.
+        // Version is read first, so the results cached under it are never older than it.
+        unsigned long version = tables.getVersion();
+        const TableSet *current = tables.readLock(reader);
+        char *lineChars;
+        searcher.setTables(*current->ipv4, *current->ipv6, version);
+        LPM_STATS_RESTART(start);
+        ok = searcher.searchBlock(block_rbuffer, head_bytes + read_bytes, lineChars, output) && searcher.finish(output);
+        LPM_STATS_PHASE(PHASE_SEARCH, start);
+        tables.readUnlock(reader);
 
-            // Block buffer is getting full, perform write() syscall
-            if (wbuffChar + MAX_LINE_LENGTH > wbuffEnd) {
-                if (!flushBuffer(STDOUT_FILENO, wbuffChar)) {
-                    return false;
-                }
-                wbuffChar = block_wbuffer;
-            }
+        // Lines which have been read are answered before waiting for more input
+        ok = ok && output.flush();
 
-            buffChar++;           // Move on next character
-            lineChars = buffChar; // Next character will be also new line
-        }
-        end_outerloop:
-
-        head_bytes = strlen(lineChars);
-        strcpy(block_rbuffer, lineChars);
+        // Incomplete last line is moved to the beginning of the block
+        head_bytes = &block_rbuffer[head_bytes + read_bytes] - lineChars;
+        memmove(block_rbuffer, lineChars, head_bytes);
 
         buff_size = RBUFFER_SIZE - tail_bytes - head_bytes;
+        LPM_STATS_RESTART(start);
+    }
+
+    tables.unregisterReader(reader);
+
+    if (cacheEntries != 0) {
+        printCacheStats(searcher.getCacheHits(), searcher.getCacheMisses());
     }
+    return ok;
+}
+
+/**
+ * Read block buffer for binary input, addresses are searched right inside it.
+ */
+static uint32_t block_binbuffer[RBUFFER_SIZE / sizeof(uint32_t)];
+
+/**
+ * Performs searching of the binary frames of the addresses which are put on the stdin.
+ * @param tables Holder of the searched tables.
+ * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+ * @param malformed Set to true if the input is malformed or truncated.
+ */
+bool performBinarySearching(TableReloader &tables, bool binaryOutput, bool &malformed) {
+
+    BinarySearcher searcher(binaryOutput);
+    OutputBuffer output(WBUFFER_SIZE, STDOUT_FILENO);
+    RcuReader *reader = tables.registerReader();
+    char *bytes = reinterpret_cast<char *>(block_binbuffer);
+    bool ok = true;
+
+    ssize_t read_bytes = 0;
+    size_t head_bytes = 0;
+    LPM_STATS_START(start);
+    while (ok && !searcher.isMalformed() && (read_bytes = read(STDIN_FILENO, &bytes[head_bytes], sizeof(block_binbuffer) - head_bytes)) > 0) {
+
+        LPM_STATS_PHASE(PHASE_READ, start);
+        size_t total = head_bytes + read_bytes;
+        size_t processed;
+
+        // Tables are held only while the block is searched, reload waits at most for one block
+        const TableSet *current = tables.readLock(reader);
+        searcher.setTables(*current->ipv4, *current->ipv6);
+        LPM_STATS_RESTART(start);
+        ok = searcher.searchBlock(block_binbuffer, total / sizeof(uint32_t), processed, output);
+        LPM_STATS_PHASE(PHASE_SEARCH, start);
+        tables.readUnlock(reader);
+
+        ok = ok && output.flush();
+
+        // Incomplete last address is moved to the beginning, it stays aligned
+        head_bytes = total - processed * sizeof(uint32_t);
+        memmove(bytes, &bytes[processed * sizeof(uint32_t)], head_bytes);
+        LPM_STATS_RESTART(start);
+    }
+
+    tables.unregisterReader(reader);
+
+    malformed = searcher.isMalformed() || (head_bytes != 0) || !searcher.isComplete();
+    return ok;
+}
+
+/**
+ * Prints shape of the current tables and the runtime counters as JSON on stderr.
+ * @param tables Holder of the searched tables.
+ * @param options Options the tables have been built with.
+ */
+void printRuntimeStats(TableReloader &tables, const TableOptions &options) {
+    RcuReader *reader = tables.registerReader();
+    const TableSet *current = tables.readLock(reader);
+
+    RuntimeStats::merge();
+    RuntimeStats::printReport(cerr, *current->ipv4, *current->ipv6, options.ipv4Engine, options.ipv6Engine);
 
-    // Flush rest of the block buffer
-    if (!flushBuffer(STDOUT_FILENO, wbuffChar)) {
-        return false;
+    tables.readUnlock(reader);
+    tables.unregisterReader(reader);
+}
+
+/**
+ * Serves lookups of the clients connected to the socket until SIGINT or SIGTERM.
+ * @param server Server with opened socket.
+ * @param verbose Print number of the served connections.
+ */
+bool performServing(LookupServer &server, bool verbose) {
+
+    bool served = server.run();
+
+    if (verbose) {
+        cerr << "Served connections: " << server.getAccepted() << endl;
     }
+    return served;
+}
 
-    return true;
+/**
+ * Performs searching of the IP addresses which are put on the stdin by more threads.
+ * @param tables Holder of the searched tables.
+ * @param threads Number of the worker threads.
+ * @param cacheEntries Number of the cached addresses of each family per thread, 0 disables the cache.
+ * @param binaryOutput Print ASNs as packed 32 bit numbers instead of lines.
+ */
+bool performParallelSearching(TableReloader &tables, int threads, size_t cacheEntries, bool binaryOutput) {
+
+    SearchPipeline pipeline(tables, threads, cacheEntries, binaryOutput);
+    bool searched = pipeline.run(STDIN_FILENO, STDOUT_FILENO);
+
+    if (cacheEntries != 0) {
+        printCacheStats(pipeline.getCacheHits(), pipeline.getCacheMisses());
+    }
+    return searched;
 }
 
 int main(int argc, char *argv[]) {
@@ -329,31 +587,178 @@ int main(int argc, char *argv[]) {
     // getting run parameters
     flags = getFlags(argc, argv, flags);
 
+    bool compile = flags.count(COMPILE) != 0;
+    bool snapshot = !compile && flags.count(TABLE_FILE);
+    string asnFilename = compile ? flags[COMPILE] : flags[ASN_FILE];
+
     // no params - print HELP text
     if (argc == 1) {
         cerr << HELP << endl;
         return EXIT_SUCCESS;
         // missing interface name
-    } else if ((!flags.count(ASN_FILE)) || (flags[ASN_FILE].empty())) {
+    } else if (!snapshot && asnFilename.empty()) {
         cerr << MSG_ERR_NO_ASN_FILE << endl;
         return ERR_ARGUMENTS;
+    } else if (compile && flags[OUTPUT_FILE].empty()) {
+        cerr << MSG_ERR_NO_OUTPUT_FILE << endl;
+        return ERR_ARGUMENTS;
+    }
+
+    int threads = flags.count(THREADS) ? atoi(flags[THREADS].c_str()) : 1;
+    if ((threads < 1) || (threads > MAX_THREADS)) {
+        cerr << MSG_ERR_INVALID_THREADS << flags[THREADS] << endl;
+        return ERR_ARGUMENTS;
+    }
+
+    TableOptions options;
+    options.ipv4Engine = flags.count(IPV4_ENGINE) ? flags[IPV4_ENGINE] : ENGINE_BIT;
+    options.ipv6Engine = flags.count(IPV6_ENGINE) ? flags[IPV6_ENGINE] : ENGINE_BIT;
+    options.asnFilename = asnFilename;
+    options.snapshotFilename = snapshot ? flags[TABLE_FILE] : string();
+    options.buildThreads = flags.count(BUILD_THREADS) ? atoi(flags[BUILD_THREADS].c_str()) : 1;
+    options.verify = flags.count(VERIFY) != 0;
+    options.aggregate = flags.count(AGGREGATE) != 0;
+    options.verbose = flags.count(VERBOSE) != 0;
+    options.rcu = NULL;
+    options.error = EXIT_SUCCESS;
+
+    if ((options.buildThreads < 1) || (options.buildThreads > MAX_THREADS)) {
+        cerr << MSG_ERR_INVALID_THREADS << flags[BUILD_THREADS] << endl;
+        return ERR_ARGUMENTS;
+    }
+
+    // Snapshot holds node arrays of the bit tries
+    if ((compile || snapshot) && ((options.ipv4Engine != ENGINE_BIT) || (options.ipv6Engine != ENGINE_BIT))) {
+        cerr << MSG_ERR_SNAPSHOT_ENGINE << endl;
+        return ERR_ARGUMENTS;
+    }
+
+    // Updates from stdin modify the tables in place, so nobody else may search them meanwhile
+    bool updates = flags.count(UPDATES) != 0;
+    bool updater = flags.count(UPDATE_FILE) != 0;
+    if ((updates || updater) && ((options.ipv4Engine != ENGINE_BIT) || (options.ipv6Engine != ENGINE_BIT))) {
+        cerr << MSG_ERR_UPDATE_ENGINE << endl;
+        return ERR_ARGUMENTS;
+    } else if (updates && updater) {
+        cerr << MSG_ERR_UPDATE_SOURCES << endl;
+        return ERR_ARGUMENTS;
+    } else if (updates && (threads != 1)) {
+        cerr << MSG_ERR_UPDATE_THREADS << endl;
+        return ERR_ARGUMENTS;
     }
 
-    AddrTrie<IPv4AddrFamily> trieIpv4;
-    AddrTrie<IPv6AddrFamily> trieIpv6;
+    // Aggregated tables do not hold the loaded prefixes, so they cannot be withdrawn or replaced
+    if (options.aggregate && (snapshot || updates || updater)) {
+        cerr << MSG_ERR_AGGREGATE_OPTIONS << endl;
+        return ERR_ARGUMENTS;
+    }
 
-    /* Load AS numbers from the file. */
-    if (!loadTrieFromFile(flags[ASN_FILE], trieIpv4, trieIpv6)) {
-        cerr << MSG_ERR_FILE_OPEN << endl;
+    long cacheEntries = flags.count(CACHE) ? atol(flags[CACHE].c_str()) : 0;
+    if (flags.count(CACHE) && ((cacheEntries < 1) || (cacheEntries > MAX_CACHE_ENTRIES))) {
+        cerr << MSG_ERR_INVALID_CACHE << flags[CACHE] << endl;
+        return ERR_ARGUMENTS;
+    }
+
+    // Server answers clients from one event loop, stdin is not read
+    bool listen = !compile && flags.count(LISTEN);
+    if (listen && (updates || (threads != 1) || (cacheEntries != 0))) {
+        cerr << MSG_ERR_LISTEN_OPTIONS << endl;
+        return ERR_ARGUMENTS;
+    }
+
+    // Binary frames are searched right inside the read block by one thread
+    bool binaryInput = !compile && flags.count(BINARY_INPUT);
+    bool binaryOutput = flags.count(BINARY_OUTPUT) != 0;
+    if (binaryInput && (updates || (threads != 1) || (cacheEntries != 0) || listen)) {
+        cerr << MSG_ERR_BINARY_OPTIONS << endl;
+        return ERR_ARGUMENTS;
+    }
+
+    if (compile) {
+        TableSet *tables = loadTables(&options);
+        if (tables == NULL) {
+            return options.error;
+        }
+
+        /* Write compiled tables into snapshot. */
+        bool written = TableSnapshot::write(flags[OUTPUT_FILE], *static_cast<AddrTrieBase *>(tables->ipv4),
+                                            *static_cast<AddrTrieBase *>(tables->ipv6));
+        delete tables;
+
+        if (!written) {
+            cerr << MSG_ERR_SNAPSHOT_WRITE << flags[OUTPUT_FILE] << endl;
+            return ERR_FILE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    TableReloader reloader(loadTables, &options);
+    options.rcu = updater ? &reloader.getRcu() : NULL;
+    if (!reloader.reload()) {
+        return options.error;
+    }
+
+    // Socket is opened before the other threads, so they inherit blocked SIGINT and SIGTERM
+    LookupServer server(reloader);
+    if (listen && !server.open(flags[LISTEN])) {
+        cerr << MSG_ERR_LISTEN << flags[LISTEN] << endl;
         return ERR_FILE;
     }
 
+    // Reload thread is started before the other threads, so they inherit blocked SIGHUP
+    if (flags.count(RELOAD) && !reloader.start(snapshot ? options.snapshotFilename : options.asnFilename)) {
+        cerr << MSG_ERR_RELOAD_THREAD << endl;
+        return ERR_FILE;
+    }
+
+    RouteUpdater routeUpdater(reloader);
+    if (updater && !routeUpdater.start(flags[UPDATE_FILE])) {
+        cerr << MSG_ERR_UPDATE_FILE << flags[UPDATE_FILE] << endl;
+        return ERR_FILE;
+    }
+
+    if (listen) {
+        bool served = performServing(server, options.verbose);
+        routeUpdater.stop();
+
+        if (flags.count(STATS)) {
+            printRuntimeStats(reloader, options);
+        }
+
+        if (!served) {
+            cerr << MSG_ERR_SERVE << endl;
+            return ERR_FILE;
+        }
+        return EXIT_SUCCESS;
+    }
+
     /* Searching the IP addresses which are put on the stdin. */
-    if (!performSearching(trieIpv4, trieIpv6)) {
+    bool malformed = false;
+    bool searched;
+    if (binaryInput) {
+        searched = performBinarySearching(reloader, binaryOutput, malformed);
+    } else if (threads == 1) {
+        searched = performSearching(reloader, updates, cacheEntries, binaryOutput);
+    } else {
+        searched = performParallelSearching(reloader, threads, cacheEntries, binaryOutput);
+    }
+    routeUpdater.stop();
+
+    if (flags.count(STATS)) {
+        printRuntimeStats(reloader, options);
+    }
+
+    if (updater && options.verbose) {
+        cerr << "Applied updates: " << routeUpdater.getApplied() << endl;
+    }
+
+    if (!searched) {
         cerr << MSG_ERR_STDOUT_IO << endl;
         return ERR_FILE;
+    } else if (malformed) {
+        cerr << MSG_ERR_BINARY_INPUT << endl;
+        return ERR_FILE;
     }
 
     return EXIT_SUCCESS;
 }
-
@@ -0,0 +1,1138 @@
+///////////////////////////////////////////////////////////////////////////////
+// Project:    Longest-Prefix Match
+// Course:     PDS (Data Communications, Computer Networks and Protocols)
+// File:       lpm_bench.cpp
+// Date:       2026
+// Author:     Longest-Prefix Match contributors
+//
+// Brief:      Benchmark of the lookup engines
+///////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file lpm_bench.cpp
+ *
+ * @brief Benchmark of the lookup engines.
+ * @author Longest-Prefix Match contributors
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+
+#include "AddrTrie.h"
+#include "Rcu.h"
+
+using namespace std;
+
+const string USAGE = "Usage: lpm_bench [-r <rounds>] [-q <queries>] [-s <seed>] [--json | --stress <readers>]\n"
+                     "                 (-g <ipv4_prefixes>,<ipv6_prefixes> | <asn_file> [<address_file>])";
+const string MSG_ERR_FILE_OPEN = "Error: Unable to open file: ";
+const string MSG_ERR_INVALID_ARGUMENTS = "Error: Invalid arguments!";
+const string MSG_ERR_DIFFERENT_ASNS = "Error: Methods found different ASNs!";
+const string MSG_ERR_STRESS = "Error: Readers of the updated table found invalid ASNs!";
+
+/**
+ * Number of the rounds of each measurement, the fastest one is reported.
+ */
+const static int DEFAULT_ROUNDS = 5;
+
+/**
+ * Number of the generated queries of each stream and family.
+ */
+const static size_t DEFAULT_QUERIES = 1000000;
+
+/**
+ * Maximal number of the timed single lookups of each method and stream.
+ */
+const static size_t LATENCY_SAMPLES = 100000;
+
+/**
+ * Distinct addresses of the skewed stream per one query of the stream.
+ */
+const static size_t SKEWED_POOL_DIVISOR = 16;
+
+/**
+ * Percentage of the generated prefixes which are more specific of the former ones.
+ */
+const static uint32_t NESTED_PERCENT = 30;
+
+/**
+ * Number of the distinct generated origin ASNs.
+ */
+const static uint32_t GENERATED_ASNS = 75000;
+
+/**
+ * Number of the prefixes of each family changed by the writer of the stress test.
+ */
+const static size_t STRESS_PREFIXES = 20000;
+
+/**
+ * Length of the prefixes changed by the writer of the stress test.
+ */
+const static int STRESS_IPV4_LENGTH = 28;
+const static int STRESS_IPV6_LENGTH = 64;
+
+/**
+ * Number of the addresses searched by the reader of the stress test inside one critical section.
+ */
+const static size_t STRESS_BATCH = 256;
+
+/**
+ * Reported latency percentiles.
+ */
+const static double PERCENTILES[] = {50, 90, 99, 99.9};
+const static char *PERCENTILE_NAMES[] = {"p50", "p90", "p99", "p99.9"};
+const static int PERCENTILE_COUNT = sizeof(PERCENTILES) / sizeof(PERCENTILES[0]);
+
+/**
+ * Results of the timed lookups are stored here, so the lookups are not optimized out.
+ */
+static volatile uint32_t searchSink;
+
+/**
+ * Share of the prefix length in the generated table.
+ */
+struct LengthWeight {
+    int length;                 /**< Length of the prefix */
+    uint32_t weight;            /**< Relative number of the prefixes of the length */
+};
+
+/**
+ * IPv4 lengths of the BGP table, /24 is the most common length followed by /22 and /23.
+ */
+const static LengthWeight IPV4_LENGTHS[] = {
+    {8, 1}, {9, 1}, {10, 3}, {11, 8}, {12, 25}, {13, 50}, {14, 100}, {15, 180}, {16, 1450},
+    {17, 800}, {18, 1350}, {19, 2500}, {20, 4000}, {21, 4500}, {22, 11500}, {23, 10500}, {24, 62000}
+};
+
+/**
+ * IPv6 lengths of the BGP table, /48 is the most common length followed by /32 and /44.
+ */
+const static LengthWeight IPV6_LENGTHS[] = {
+    {19, 2}, {20, 10}, {22, 20}, {24, 80}, {28, 300}, {29, 1500}, {30, 300}, {31, 200}, {32, 7500},
+    {33, 1000}, {34, 1200}, {35, 500}, {36, 1700}, {37, 300}, {38, 600}, {39, 400}, {40, 3500},
+    {41, 300}, {42, 1000}, {43, 300}, {44, 4500}, {45, 1200}, {46, 2500}, {47, 1500}, {48, 27000},
+    {56, 50}, {64, 20}
+};
+
+/**
+ * Returns monotonic time.
+ * @return Time in seconds.
+ */
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * Pseudorandom generator (SplitMix64), the same seed gives the same tables
+ * and queries on every machine.
+ */
+class Random
+{
+public:
+    /**
+     * Constructs generator.
+     * @param seed Initial state.
+     */
+    Random(uint64_t seed) : _state(seed) {}
+
+    /**
+     * Returns next random word.
+     * @return Random 64 bit word.
+     */
+    inline uint64_t next() {
+        uint64_t z = (_state += 0x9E3779B97F4A7C15);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+        return z ^ (z >> 31);
+    }
+
+    /**
+     * Returns random number lower than the limit.
+     * @param limit Upper bound (exclusive), greater than 0.
+     * @return Random number.
+     */
+    inline size_t operator()(size_t limit) {
+        return next() % limit;
+    }
+
+private:
+    uint64_t _state;            /**< State of the generator */
+};
+
+/**
+ * Addresses of one family prepared for searching.
+ */
+struct Queries {
+    string stream;              /**< Name of the query stream */
+    vector<uint32_t> addrs;     /**< Addresses as host ordered 32 bit words */
+    size_t count;               /**< Number of the addresses */
+    vector<uint32_t> out;       /**< Found ASNs */
+};
+
+/**
+ * Measured searching method of the trie.
+ */
+enum methods {
+    GENERIC_SINGLE = 0,         /**< AddrTrieBase::longestPrefixMatch() */
+    GENERIC_BATCH = 1,          /**< AddrTrieBase::longestPrefixMatchBatch() */
+    FAMILY_SINGLE = 2,          /**< FamilyTrie::longestPrefixMatch() */
+    FAMILY_BATCH = 3,           /**< FamilyTrie::longestPrefixMatchBatch() */
+    POPTRIE_SINGLE = 4,         /**< PoptrieBase::longestPrefixMatch() */
+    POPTRIE_BATCH = 5,          /**< PoptrieBase::longestPrefixMatchBatch() */
+    LEAFPUSH_SINGLE = 6,        /**< LeafPushedTrieBase::longestPrefixMatch() */
+    LEAFPUSH_BATCH = 7          /**< LeafPushedTrieBase::longestPrefixMatchBatch() */
+           };
+
+/**
+ * Number of the measured methods.
+ */
+const static int METHODS = 8;
+
+/**
+ * Names of the measured methods.
+ */
+const static char *METHOD_NAMES[METHODS] = {"generic single", "generic batch", "family single", "family batch",
+                                            "poptrie single", "poptrie batch", "leafpush single", "leafpush batch"};
+
+/**
+ * Tables of one family searched by the methods.
+ */
+template<class AddrFamily>
+struct Tables {
+    AddrTrie<AddrFamily> trie;                   /**< Bit trie */
+    AddrTrie<AddrFamily, PoptrieBase> poptrie;   /**< Poptrie compiled from the same prefixes */
+    AddrTrie<AddrFamily, LeafPushedTrieBase> leafpush; /**< Leaf-pushed trie from the same prefixes */
+};
+
+/**
+ * Measured construction of one table.
+ */
+struct TableResult {
+    string family;              /**< Address family */
+    string engine;              /**< Engine of the table */
+    size_t prefixes;            /**< Number of the stored prefixes */
+    double build;               /**< Time of inserting and building in seconds */
+    size_t bytes;               /**< Memory of the table */
+};
+
+/**
+ * Measured searching of one stream by one method.
+ */
+struct LookupResult {
+    string family;              /**< Address family */
+    string stream;              /**< Name of the query stream */
+    int method;                 /**< Searching method */
+    size_t queries;             /**< Number of the searched addresses */
+    double best;                /**< Time of the fastest round in seconds */
+    double speedup;             /**< Speedup against the generic method of the same kind */
+    double percentiles[PERCENTILE_COUNT]; /**< Latencies of the single lookups in ns, unset for batch */
+};
+
+/**
+ * Results of the whole benchmark.
+ */
+struct Report {
+    int rounds;                 /**< Number of the rounds of each measurement */
+    uint64_t seed;              /**< Seed of the generators */
+    string source;              /**< Generated tables or name of the file */
+    vector<TableResult> tables; /**< Measured tables */
+    vector<LookupResult> lookups; /**< Measured searching */
+    bool same;                  /**< All methods found the same ASNs */
+};
+
+/**
+ * Orders prefixes by the address and the length.
+ * @param first First prefix.
+ * @param second Second prefix.
+ * @return True if the first prefix goes before the second one.
+ */
+bool lessPrefix(const PrefixRecord &first, const PrefixRecord &second) {
+    int compared = memcmp(first.addr, second.addr, sizeof(first.addr));
+    return (compared != 0) ? (compared < 0) : (first.prefix < second.prefix);
+}
+
+/**
+ * Compares prefixes regardless of their ASN.
+ * @param first First prefix.
+ * @param second Second prefix.
+ * @return True if both prefixes are the same.
+ */
+bool samePrefix(const PrefixRecord &first, const PrefixRecord &second) {
+    return (memcmp(first.addr, second.addr, sizeof(first.addr)) == 0) && (first.prefix == second.prefix);
+}
+
+/**
+ * Generates prefixes with the lengths distributed like in the BGP table.
+ * Part of the prefixes are more specifics of the former ones, other
+ * are placed into unicast space (IPv4 1-223 without 10 and 127, IPv6 2000::/3).
+ * @param random Generator.
+ * @param words Number of the words of the address.
+ * @param lengths Weights of the prefix lengths.
+ * @param lengthCount Number of the weighted lengths.
+ * @param count Number of the distinct prefixes.
+ * @param records Generated prefixes in random order.
+ */
+void generatePrefixes(Random &random, int words, const LengthWeight *lengths, size_t lengthCount,
+                      size_t count, vector<PrefixRecord> &records) {
+    uint32_t totalWeight = 0;
+    for (size_t i = 0; i < lengthCount; i++) {
+        totalWeight += lengths[i].weight;
+    }
+
+    records.clear();
+    while (records.size() < count) {
+        for (size_t missing = count - records.size(); missing > 0; missing--) {
+            PrefixRecord record;
+            uint32_t pick = random(totalWeight);
+            size_t i = 0;
+            while (pick >= lengths[i].weight) {
+                pick -= lengths[i++].weight;
+            }
+            record.prefix = lengths[i].length;
+            record.asn = 1 + random(GENERATED_ASNS);
+
+            for (int word = 0; word < 4; word++) {
+                record.addr[word] = (word < words) ? (uint32_t)random.next() : 0;
+            }
+
+            const PrefixRecord *covering = records.empty() ? NULL : &records[random(records.size())];
+            if ((random(100) < NESTED_PERCENT) && (covering != NULL) && (covering->prefix < record.prefix)) {
+                for (int bit = 0; bit < covering->prefix; bit++) {    // More specific of the former prefix
+                    uint32_t mask = 0x80000000 >> (bit % 32);
+                    record.addr[bit / 32] = (record.addr[bit / 32] & ~mask) | (covering->addr[bit / 32] & mask);
+                }
+            } else if (words == 1) {
+                uint32_t octet;
+                do {
+                    octet = 1 + random(223);
+                } while ((octet == 10) || (octet == 127));
+                record.addr[0] = (octet << 24) | (record.addr[0] & 0x00FFFFFF);
+            } else {
+                record.addr[0] = 0x20000000 | (record.addr[0] & 0x1FFFFFFF);
+            }
+
+            for (int bit = record.prefix; bit < words * 32; bit++) {  // Host bits are cleared
+                record.addr[bit / 32] &= ~(0x80000000 >> (bit % 32));
+            }
+            records.push_back(record);
+        }
+
+        sort(records.begin(), records.end(), lessPrefix);
+        records.erase(unique(records.begin(), records.end(), samePrefix), records.end());
+    }
+
+    random_shuffle(records.begin(), records.end(), random);
+}
+
+/**
+ * Reads prefixes from the file with ASN records "address/prefix asn".
+ * @param filename Filename of the file with AS numbers.
+ * @param ipv4Records Read IPv4 prefixes.
+ * @param ipv6Records Read IPv6 prefixes.
+ * @return True if no error occurs, false if the file could not be read.
+ */
+bool readPrefixes(const string &filename, vector<PrefixRecord> &ipv4Records, vector<PrefixRecord> &ipv6Records) {
+    ifstream file(filename.c_str());
+    if (!file) {
+        return false;
+    }
+
+    string line;
+    while (getline(file, line)) {
+        size_t slash = line.find('/');
+        if (slash == string::npos) {
+            continue;
+        }
+
+        PrefixRecord record;
+        memset(record.addr, 0, sizeof(record.addr));
+        vector<PrefixRecord> *records = &ipv4Records;
+        if (IPv4AddrFamily::parse(line.c_str(), record.addr) != slash) {
+            records = &ipv6Records;
+            if (IPv6AddrFamily::parse(line.c_str(), record.addr) != slash) {
+                continue;
+            }
+        }
+
+        char *asnChars;
+        record.prefix = strtol(line.c_str() + slash + 1, &asnChars, 10);
+        record.asn = strtoul(asnChars, NULL, 10);
+        records->push_back(record);
+    }
+
+    return true;
+}
+
+/**
+ * Reads addresses of both families from the file.
+ * @param filename Filename of the file with one address per line.
+ * @param ipv4Queries Read IPv4 addresses.
+ * @param ipv6Queries Read IPv6 addresses.
+ * @return True if no error occurs, false if the file could not be read.
+ */
+bool readQueries(const string &filename, Queries &ipv4Queries, Queries &ipv6Queries) {
+    ifstream file(filename.c_str());
+    if (!file) {
+        return false;
+    }
+
+    string line;
+    uint32_t addr[4];
+    while (getline(file, line)) {
+        size_t length = IPv4AddrFamily::parse(line.c_str(), addr);
+        if ((length != 0) && (length == line.size())) {
+            ipv4Queries.addrs.push_back(addr[0]);
+            continue;
+        }
+
+        length = IPv6AddrFamily::parse(line.c_str(), addr);
+        if ((length != 0) && (length == line.size())) {
+            ipv6Queries.addrs.insert(ipv6Queries.addrs.end(), addr, addr + 4);
+        }
+    }
+
+    ipv4Queries.stream = ipv6Queries.stream = "file";
+    ipv4Queries.count = ipv4Queries.addrs.size();
+    ipv4Queries.out.resize(ipv4Queries.count);
+    ipv6Queries.count = ipv6Queries.addrs.size() / 4;
+    ipv6Queries.out.resize(ipv6Queries.count);
+    return true;
+}
+
+/**
+ * Generates addresses inside the prefixes of the table, prefix is chosen
+ * uniformly and its host bits are random.
+ * @param random Generator.
+ * @param words Number of the words of the address.
+ * @param records Prefixes of the table.
+ * @param count Number of the generated addresses.
+ * @param addrs Generated addresses are appended here.
+ */
+void generateAddrs(Random &random, int words, const vector<PrefixRecord> &records, size_t count,
+                   vector<uint32_t> &addrs) {
+    for (size_t i = 0; i < count; i++) {
+        const PrefixRecord &record = records[random(records.size())];
+        for (int word = 0; word < words; word++) {
+            int hostBits = (word + 1) * 32 - record.prefix;
+            uint32_t hostMask = (hostBits <= 0) ? 0 : (hostBits >= 32) ? 0xFFFFFFFF : (1U << hostBits) - 1;
+            addrs.push_back((record.addr[word] & ~hostMask) | ((uint32_t)random.next() & hostMask));
+        }
+    }
+}
+
+/**
+ * Generates query streams over the table: uniform addresses of the routed
+ * prefixes, skewed stream where few addresses take most of the queries
+ * (Zipf distribution, s = 1) and the uniform addresses sorted.
+ * @param random Generator.
+ * @param words Number of the words of the address.
+ * @param records Prefixes of the table.
+ * @param count Number of the addresses of each stream.
+ * @param streams Generated streams.
+ */
+void generateQueries(Random &random, int words, const vector<PrefixRecord> &records, size_t count,
+                     vector<Queries> &streams) {
+    streams.resize(3);
+    streams[0].stream = "uniform";
+    streams[1].stream = "skewed";
+    streams[2].stream = "sorted";
+    if (records.empty()) {
+        count = 0;
+    }
+
+    generateAddrs(random, words, records, count, streams[0].addrs);
+
+    /* Address of the rank r is chosen with probability proportional to 1 / r */
+    vector<uint32_t> pool;
+    generateAddrs(random, words, records, (count == 0) ? 0 : count / SKEWED_POOL_DIVISOR + 1, pool);
+    vector<double> cumulative(pool.size() / words);
+    double total = 0;
+    for (size_t rank = 0; rank < cumulative.size(); rank++) {
+        total += 1.0 / (rank + 1);
+        cumulative[rank] = total;
+    }
+    for (size_t i = 0; (i < count) && !pool.empty(); i++) {
+        double pick = (random.next() >> 11) * (1.0 / 9007199254740992.0) * total;
+        size_t rank = lower_bound(cumulative.begin(), cumulative.end(), pick) - cumulative.begin();
+        rank = (rank < cumulative.size()) ? rank : cumulative.size() - 1;
+        streams[1].addrs.insert(streams[1].addrs.end(), &pool[rank * words], &pool[rank * words] + words);
+    }
+
+    /* Addresses are sorted as whole, IPv6 as four word tuples */
+    streams[2].addrs = streams[0].addrs;
+    if (words == 1) {
+        sort(streams[2].addrs.begin(), streams[2].addrs.end());
+    } else {
+        vector<PrefixRecord> sorted(count);
+        for (size_t i = 0; i < count; i++) {
+            memcpy(sorted[i].addr, &streams[0].addrs[i * 4], sizeof(sorted[i].addr));
+            sorted[i].prefix = 0;
+        }
+        sort(sorted.begin(), sorted.end(), lessPrefix);
+        for (size_t i = 0; i < count; i++) {
+            memcpy(&streams[2].addrs[i * 4], sorted[i].addr, sizeof(sorted[i].addr));
+        }
+    }
+
+    for (size_t i = 0; i < streams.size(); i++) {
+        streams[i].count = streams[i].addrs.size() / words;
+        streams[i].out.resize(streams[i].count);
+    }
+}
+
+/**
+ * Inserts prefixes into the table and builds it.
+ * @param title Title of the family.
+ * @param engine Name of the engine.
+ * @param table Built table.
+ * @param records Inserted prefixes.
+ * @param report Report where the result is added.
+ */
+void buildTable(const string &title, const string &engine, AddrLookupBase &table,
+                const vector<PrefixRecord> &records, Report &report) {
+    TableResult result;
+    LookupStats stats;
+
+    double start = now();
+    table.insertRecords(&records, 1, 1);
+    table.build();
+    result.build = now() - start;
+
+    table.getStats(stats);
+    result.family = title;
+    result.engine = engine;
+    result.prefixes = stats.prefixes;
+    result.bytes = stats.bytes;
+    report.tables.push_back(result);
+}
+
+/**
+ * Searches one address by the single lookup method.
+ * @param tables Searched tables.
+ * @param addr Searched address.
+ * @param method Single lookup method.
+ * @return Found ASN.
+ */
+template<class AddrFamily>
+inline uint32_t searchOne(Tables<AddrFamily> &tables, uint32_t *addr, int method) {
+    switch (method) {
+    case GENERIC_SINGLE:
+        return tables.trie.AddrTrieBase::longestPrefixMatch(addr);
+    case FAMILY_SINGLE:
+        return tables.trie.FamilyTrie<AddrFamily>::longestPrefixMatch(addr);
+    case POPTRIE_SINGLE:
+        return tables.poptrie.longestPrefixMatch(addr);
+    default:
+        return tables.leafpush.longestPrefixMatch(addr);
+    }
+}
+
+/**
+ * Searches all queries by the method.
+ * @param tables Searched tables.
+ * @param queries Searched addresses, results are stored into them.
+ * @param method Searching method.
+ */
+template<class AddrFamily>
+void search(Tables<AddrFamily> &tables, Queries &queries, int method) {
+    AddrTrie<AddrFamily> &trie = tables.trie;
+    const int words = AddrFamily::BIT_LENGTH / 32;
+    uint32_t *addrs = &queries.addrs[0];
+    uint32_t *out = &queries.out[0];
+
+    switch (method) {
+    case GENERIC_SINGLE:
+        for (size_t i = 0; i < queries.count; i++) {
+            out[i] = trie.AddrTrieBase::longestPrefixMatch(&addrs[i * words]);
+        }
+        break;
+    case GENERIC_BATCH:
+        trie.AddrTrieBase::longestPrefixMatchBatch(addrs, queries.count, out);
+        break;
+    case FAMILY_SINGLE:
+        for (size_t i = 0; i < queries.count; i++) {
+            out[i] = trie.FamilyTrie<AddrFamily>::longestPrefixMatch(&addrs[i * words]);
+        }
+        break;
+    case FAMILY_BATCH:
+        trie.FamilyTrie<AddrFamily>::longestPrefixMatchBatch(addrs, queries.count, out);
+        break;
+    case POPTRIE_SINGLE:
+        for (size_t i = 0; i < queries.count; i++) {
+            out[i] = tables.poptrie.longestPrefixMatch(&addrs[i * words]);
+        }
+        break;
+    case POPTRIE_BATCH:
+        tables.poptrie.longestPrefixMatchBatch(addrs, queries.count, out);
+        break;
+    case LEAFPUSH_SINGLE:
+        for (size_t i = 0; i < queries.count; i++) {
+            out[i] = tables.leafpush.longestPrefixMatch(&addrs[i * words]);
+        }
+        break;
+    case LEAFPUSH_BATCH:
+        tables.leafpush.longestPrefixMatchBatch(addrs, queries.count, out);
+        break;
+    }
+}
+
+/**
+ * Returns cost of reading the time, it is subtracted from the timed lookups.
+ * @return The lowest measured difference of two readings in seconds.
+ */
+static double timerOverhead() {
+    double overhead = 1;
+    for (int i = 0; i < 1000; i++) {
+        double start = now();
+        double elapsed = now() - start;
+        overhead = (elapsed < overhead) ? elapsed : overhead;
+    }
+    return overhead;
+}
+
+/**
+ * Times single lookups of evenly spread addresses of the stream.
+ * @param tables Searched tables.
+ * @param queries Searched addresses.
+ * @param method Single lookup method.
+ * @param overhead Cost of reading the time in seconds.
+ * @param percentiles Latencies of the PERCENTILES in ns.
+ */
+template<class AddrFamily>
+void measureLatency(Tables<AddrFamily> &tables, Queries &queries, int method, double overhead,
+                    double *percentiles) {
+    const int words = AddrFamily::BIT_LENGTH / 32;
+    size_t step = (queries.count + LATENCY_SAMPLES - 1) / LATENCY_SAMPLES;
+    vector<double> latencies;
+    uint32_t found = 0;
+
+    latencies.reserve(queries.count / step + 1);
+    for (size_t i = 0; i < queries.count; i += step) {
+        double start = now();
+        found ^= searchOne(tables, &queries.addrs[i * words], method);
+        double elapsed = now() - start - overhead;
+        latencies.push_back((elapsed > 0) ? elapsed * 1e9 : 0);
+    }
+    searchSink = found;
+
+    sort(latencies.begin(), latencies.end());
+    for (int i = 0; i < PERCENTILE_COUNT; i++) {
+        percentiles[i] = latencies[(size_t)(PERCENTILES[i] / 100 * (latencies.size() - 1))];
+    }
+}
+
+/**
+ * Measures all methods over the queries, results are added into report.
+ * @param title Title of the family.
+ * @param tables Searched tables.
+ * @param queries Searched addresses.
+ * @param report Report where the results are added.
+ * @return True if all methods found the same ASNs, else false.
+ */
+template<class AddrFamily>
+bool measure(const string &title, Tables<AddrFamily> &tables, Queries &queries, Report &report) {
+    double best[METHODS];
+    double overhead = timerOverhead();
+    vector<uint32_t> expected;
+    bool same = true;
+
+    if (queries.count == 0) {
+        return true;
+    }
+
+    for (int method = GENERIC_SINGLE; method < METHODS; method++) {
+        LookupResult result;
+
+        best[method] = 0;
+        for (int round = 0; round < report.rounds; round++) {
+            double start = now();
+            search(tables, queries, method);
+            double elapsed = now() - start;
+            if ((round == 0) || (elapsed < best[method])) {
+                best[method] = elapsed;
+            }
+        }
+
+        // Every method has to find the same ASNs as the first one
+        if (method == GENERIC_SINGLE) {
+            expected = queries.out;
+        } else if (queries.out != expected) {
+            same = false;
+        }
+
+        result.family = title;
+        result.stream = queries.stream;
+        result.method = method;
+        result.queries = queries.count;
+        result.best = best[method];
+        result.speedup = best[method % 2] / best[method];   // Compared with the generic method of the same kind
+        for (int i = 0; i < PERCENTILE_COUNT; i++) {
+            result.percentiles[i] = -1;
+        }
+        if (method % 2 == GENERIC_SINGLE) {
+            measureLatency(tables, queries, method, overhead, result.percentiles);
+        }
+        report.lookups.push_back(result);
+    }
+
+    return same;
+}
+
+/**
+ * Prints report as text.
+ * @param report Results of the benchmark.
+ */
+void printText(const Report &report) {
+    cout << "Tables " << report.source << ", rounds " << report.rounds << endl;
+
+    for (size_t i = 0; i < report.tables.size(); i++) {
+        const TableResult &table = report.tables[i];
+        cout << table.family << " " << setw(8) << left << table.engine << right
+             << setw(8) << table.prefixes << " prefixes"
+             << setw(9) << fixed << setprecision(3) << table.build << " s build"
+             << setw(12) << table.bytes << " B"
+             << setw(8) << setprecision(1) << (table.prefixes ? (double)table.bytes / table.prefixes : 0.0)
+             << " B/prefix" << endl;
+    }
+
+    for (size_t i = 0; i < report.lookups.size(); i++) {
+        const LookupResult &lookup = report.lookups[i];
+        cout << lookup.family << " " << setw(8) << left << lookup.stream << setw(15) << METHOD_NAMES[lookup.method]
+             << right << setw(8) << fixed << setprecision(1) << lookup.best * 1e9 / lookup.queries << " ns/lookup"
+             << setw(8) << setprecision(2) << lookup.queries / lookup.best / 1e6 << " Mlookups/s";
+        if (lookup.method >= FAMILY_SINGLE) {
+            cout << "  speedup " << setprecision(2) << lookup.speedup << "x";
+        }
+        if (lookup.percentiles[0] >= 0) {
+            cout << " " << setprecision(0);
+            for (int p = 0; p < PERCENTILE_COUNT; p++) {
+                cout << " " << PERCENTILE_NAMES[p] << " " << lookup.percentiles[p];
+            }
+            cout << " ns";
+        }
+        cout << endl;
+    }
+}
+
+/**
+ * Prints report as JSON document.
+ * @param report Results of the benchmark.
+ */
+void printJson(const Report &report) {
+    cout << "{\n  \"source\": \"" << report.source << "\",\n  \"seed\": " << report.seed
+         << ",\n  \"rounds\": " << report.rounds << ",\n  \"verified\": " << (report.same ? "true" : "false")
+         << ",\n  \"tables\": [";
+
+    for (size_t i = 0; i < report.tables.size(); i++) {
+        const TableResult &table = report.tables[i];
+        cout << ((i == 0) ? "\n" : ",\n") << fixed << setprecision(6)
+             << "    {\"family\": \"" << table.family << "\", \"engine\": \"" << table.engine
+             << "\", \"prefixes\": " << table.prefixes << ", \"build_s\": " << table.build
+             << ", \"bytes\": " << table.bytes << ", \"bytes_per_prefix\": " << setprecision(2)
+             << (table.prefixes ? (double)table.bytes / table.prefixes : 0.0) << "}";
+    }
+
+    cout << "\n  ],\n  \"lookups\": [";
+    for (size_t i = 0; i < report.lookups.size(); i++) {
+        const LookupResult &lookup = report.lookups[i];
+        cout << ((i == 0) ? "\n" : ",\n") << fixed << setprecision(3)
+             << "    {\"family\": \"" << lookup.family << "\", \"stream\": \"" << lookup.stream
+             << "\", \"method\": \"" << METHOD_NAMES[lookup.method] << "\", \"queries\": " << lookup.queries
+             << ", \"ns_per_lookup\": " << lookup.best * 1e9 / lookup.queries
+             << ", \"mlookups_per_s\": " << lookup.queries / lookup.best / 1e6
+             << ", \"speedup\": " << lookup.speedup;
+        if (lookup.percentiles[0] >= 0) {
+            cout << setprecision(1);
+            for (int p = 0; p < PERCENTILE_COUNT; p++) {
+                cout << ", \"" << PERCENTILE_NAMES[p] << "_ns\": " << lookup.percentiles[p];
+            }
+        }
+        cout << "}";
+    }
+    cout << "\n  ]\n}" << endl;
+}
+
+/**
+ * Creates more specific of the table prefixes for the writer of the stress test.
+ * Changed prefixes have the same length, so they never overlap each other,
+ * and none of them is stored in the table already.
+ * @param random Generator.
+ * @param words Number of the words of the address.
+ * @param records Prefixes of the table.
+ * @param length Length of the changed prefixes.
+ * @param count Number of the generated prefixes, duplicates are removed.
+ * @param changes Generated prefixes in random order.
+ */
+void generateChanges(Random &random, int words, const vector<PrefixRecord> &records, int length, size_t count,
+                     vector<PrefixRecord> &changes) {
+    vector<PrefixRecord> sorted(records);
+    sort(sorted.begin(), sorted.end(), lessPrefix);
+
+    changes.clear();
+    for (size_t i = 0; (i < count) && !records.empty(); i++) {
+        const PrefixRecord &covering = records[random(records.size())];
+        PrefixRecord change;
+        change.prefix = length;
+        change.asn = 1 + random(GENERATED_ASNS);
+
+        for (int word = 0; word < 4; word++) {
+            change.addr[word] = (word < words) ? (uint32_t)random.next() : 0;
+        }
+        for (int bit = 0; bit < words * 32; bit++) {
+            uint32_t mask = 0x80000000 >> (bit % 32);
+            if (bit >= length) {                // Host bits are cleared
+                change.addr[bit / 32] &= ~mask;
+            } else if (bit < covering.prefix) { // More specific of the table prefix
+                change.addr[bit / 32] = (change.addr[bit / 32] & ~mask) | (covering.addr[bit / 32] & mask);
+            }
+        }
+
+        if (!binary_search(sorted.begin(), sorted.end(), change, lessPrefix)) {
+            changes.push_back(change);
+        }
+    }
+
+    sort(changes.begin(), changes.end(), lessPrefix);
+    changes.erase(unique(changes.begin(), changes.end(), samePrefix), changes.end());
+    random_shuffle(changes.begin(), changes.end(), random);
+}
+
+/**
+ * Shared state of the stress test of one family.
+ */
+template<class AddrFamily>
+struct StressTest {
+    AddrTrie<AddrFamily> trie;  /**< Live table changed by the writer */
+    RcuDomain rcu;              /**< Domain of the readers of the live table */
+    vector<uint32_t> addrs;     /**< Searched addresses */
+    vector<uint32_t> without;   /**< ASNs of the addresses in the table without the changed prefixes */
+    vector<uint32_t> with;      /**< ASNs of the addresses in the table with all changed prefixes */
+    bool stop;                  /**< Writer has finished, accessed atomically */
+};
+
+/**
+ * Reader thread of the stress test.
+ */
+template<class AddrFamily>
+struct StressReader {
+    StressTest<AddrFamily> *test; /**< Shared state */
+    bool batch;                 /**< Searches by longestPrefixMatchBatch() instead of longestPrefixMatch() */
+    size_t lookups;             /**< Number of the searched addresses */
+    size_t mismatches;          /**< Number of the ASNs which match neither reference */
+    pthread_t thread;           /**< Thread of the reader */
+};
+
+/**
+ * Searches the addresses in the live table until the writer finishes, but
+ * at least once. Changed prefixes never overlap, so every address is covered
+ * by at most one of them and its ASN has to be one of both references.
+ * @param readerPtr Reader of the stress test.
+ * @return Always NULL.
+ */
+template<class AddrFamily>
+void *stressReader(void *readerPtr) {
+    StressReader<AddrFamily> *reader = static_cast<StressReader<AddrFamily> *>(readerPtr);
+    StressTest<AddrFamily> &test = *reader->test;
+    const int words = AddrFamily::BIT_LENGTH / 32;
+    size_t count = test.without.size();
+    uint32_t out[STRESS_BATCH];
+    RcuReader *rcuReader = test.rcu.registerReader();
+
+    size_t base = 0;
+    bool searched = false;
+    while (!searched || !__atomic_load_n(&test.stop, __ATOMIC_ACQUIRE)) {
+        size_t n = (count - base < STRESS_BATCH) ? count - base : STRESS_BATCH;
+        uint32_t *addrs = &test.addrs[base * words];
+
+        test.rcu.readLock(rcuReader);
+        if (reader->batch) {
+            test.trie.longestPrefixMatchBatch(addrs, n, out);
+        } else {
+            for (size_t i = 0; i < n; i++) {
+                out[i] = test.trie.longestPrefixMatch(&addrs[i * words]);
+            }
+        }
+        test.rcu.readUnlock(rcuReader);
+
+        for (size_t i = 0; i < n; i++) {
+            if ((out[i] != test.without[base + i]) && (out[i] != test.with[base + i])) {
+                reader->mismatches++;
+            }
+        }
+        reader->lookups += n;
+
+        base += n;
+        if (base == count) {
+            base = 0;
+            searched = true;
+        }
+    }
+
+    test.rcu.unregisterReader(rcuReader);
+    return NULL;
+}
+
+/**
+ * Runs readers of the live table while single writer announces and withdraws
+ * the changed prefixes through update() and withdraw(). Removed nodes and
+ * replaced node arrays are reclaimed through the RCU domain of the readers.
+ * Half of the readers search addresses one by one, the other half by batches.
+ * All changed prefixes are withdrawn at the end, so the table has to give
+ * exactly the ASNs of the reference again.
+ * @param title Title of the family.
+ * @param records Prefixes of the table.
+ * @param length Length of the changed prefixes.
+ * @param random Generator.
+ * @param queryCount Number of the searched addresses.
+ * @param rounds Number of the writer passes over the changed prefixes.
+ * @param readers Number of the reader threads.
+ * @return True if all readers found valid ASNs and the writer succeeded, else false.
+ */
+template<class AddrFamily>
+bool stress(const string &title, const vector<PrefixRecord> &records, int length, Random &random,
+            size_t queryCount, int rounds, int readers) {
+    const int words = AddrFamily::BIT_LENGTH / 32;
+    StressTest<AddrFamily> test;
+    AddrTrie<AddrFamily> with;
+    vector<PrefixRecord> changes;
+
+    if (records.empty() || (queryCount == 0)) {
+        return true;
+    }
+
+    /* References are searched in the tables without and with all changed prefixes */
+    generateChanges(random, words, records, length, STRESS_PREFIXES, changes);
+    test.trie.insertRecords(&records, 1, 1);
+    with.insertRecords(&records, 1, 1);
+    with.insertRecords(&changes, 1, 1);
+
+    generateAddrs(random, words, records, queryCount / 2, test.addrs);
+    generateAddrs(random, words, changes, queryCount - queryCount / 2, test.addrs);
+    test.without.resize(queryCount);
+    test.with.resize(queryCount);
+    for (size_t i = 0; i < queryCount; i++) {
+        test.without[i] = test.trie.longestPrefixMatch(&test.addrs[i * words]);
+        test.with[i] = with.longestPrefixMatch(&test.addrs[i * words]);
+    }
+
+    test.trie.setReclaimDomain(&test.rcu);
+    test.stop = false;
+    vector<StressReader<AddrFamily> > threads(readers);
+    for (int i = 0; i < readers; i++) {
+        threads[i].test = &test;
+        threads[i].batch = (i % 2 == 1);
+        threads[i].lookups = 0;
+        threads[i].mismatches = 0;
+        pthread_create(&threads[i].thread, NULL, stressReader<AddrFamily>, &threads[i]);
+    }
+
+    /* Writer toggles the changed prefixes in random order every round */
+    vector<size_t> order(changes.size());
+    vector<bool> stored(changes.size(), false);
+    size_t updates = 0;
+    size_t refused = 0;
+    double start = now();
+    for (size_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    for (int round = 0; round < rounds; round++) {
+        random_shuffle(order.begin(), order.end(), random);
+        for (size_t i = 0; i < order.size(); i++) {
+            PrefixRecord &change = changes[order[i]];
+            bool applied = stored[order[i]] ? test.trie.withdraw(change.addr, change.prefix)
+                                            : test.trie.update(change.addr, change.prefix, change.asn);
+            stored[order[i]] = !stored[order[i]];
+            refused += applied ? 0 : 1;
+            updates++;
+        }
+    }
+    for (size_t i = 0; i < changes.size(); i++) {
+        if (stored[i]) {
+            refused += test.trie.withdraw(changes[i].addr, changes[i].prefix) ? 0 : 1;
+            updates++;
+        }
+    }
+    double elapsed = now() - start;
+    __atomic_store_n(&test.stop, true, __ATOMIC_RELEASE);
+
+    size_t lookups = 0;
+    size_t mismatches = 0;
+    for (int i = 0; i < readers; i++) {
+        pthread_join(threads[i].thread, NULL);
+        lookups += threads[i].lookups;
+        mismatches += threads[i].mismatches;
+    }
+
+    /* Table without the changed prefixes has to be the reference again */
+    size_t remaining = 0;
+    vector<uint32_t> out(queryCount);
+    test.trie.longestPrefixMatchBatch(&test.addrs[0], queryCount, &out[0]);
+    for (size_t i = 0; i < queryCount; i++) {
+        if ((out[i] != test.without[i]) || (test.trie.longestPrefixMatch(&test.addrs[i * words]) != test.without[i])) {
+            remaining++;
+        }
+    }
+
+    cout << title << " stress: " << readers << " readers, " << changes.size() << " changed prefixes, "
+         << updates << " updates in " << fixed << setprecision(3) << elapsed << " s, "
+         << refused << " refused, " << lookups << " lookups, " << mismatches << " mismatches, "
+         << remaining << " mismatches after updates" << endl;
+
+    return (mismatches == 0) && (refused == 0) && (remaining == 0);
+}
+
+/**
+ * Long options for getopt_long function.
+ */
+static const struct option LONG_OPTIONS[] = {
+    {"json", no_argument, NULL, 'J'},
+    {"stress", required_argument, NULL, 'S'},
+    {NULL, 0, NULL, 0}
+};
+
+int main(int argc, char *argv[]) {
+    Report report;
+    size_t queryCount = DEFAULT_QUERIES;
+    size_t generated[2] = {0, 0};
+    bool generate = false;
+    bool json = false;
+    int stressReaders = 0;
+    int ch;
+
+    report.rounds = DEFAULT_ROUNDS;
+    report.seed = 1;
+    report.same = true;
+
+    while ((ch = getopt_long(argc, argv, "r:q:s:g:", LONG_OPTIONS, NULL)) != -1) {
+        switch (ch) {
+        case 'r':
+            report.rounds = atoi(optarg);
+            break;
+        case 'q':
+            queryCount = strtoul(optarg, NULL, 10);
+            break;
+        case 's':
+            report.seed = strtoul(optarg, NULL, 10);
+            break;
+        case 'g':
+            generate = (sscanf(optarg, "%lu,%lu", (unsigned long *)&generated[0],
+                               (unsigned long *)&generated[1]) == 2);
+            if (!generate) {
+                cerr << MSG_ERR_INVALID_ARGUMENTS << endl << USAGE << endl;
+                return EXIT_FAILURE;
+            }
+            break;
+        case 'J':
+            json = true;
+            break;
+        case 'S':
+            stressReaders = atoi(optarg);
+            if (stressReaders < 1) {
+                cerr << MSG_ERR_INVALID_ARGUMENTS << endl << USAGE << endl;
+                return EXIT_FAILURE;
+            }
+            break;
+        default:
+            cerr << USAGE << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Former form "<asn_file> <address_file> [rounds]" is still accepted
+    int positional = argc - optind;
+    if ((generate == (positional != 0)) || (positional > 3)) {
+        cerr << USAGE << endl;
+        return EXIT_FAILURE;
+    }
+    if (positional == 3) {
+        report.rounds = atoi(argv[optind + 2]);
+    }
+    if (report.rounds < 1) {
+        report.rounds = 1;
+    }
+
+    Random random(report.seed);
+    vector<PrefixRecord> ipv4Records, ipv6Records;
+    if (generate) {
+        generatePrefixes(random, 1, IPV4_LENGTHS, sizeof(IPV4_LENGTHS) / sizeof(IPV4_LENGTHS[0]),
+                         generated[0], ipv4Records);
+        generatePrefixes(random, 4, IPV6_LENGTHS, sizeof(IPV6_LENGTHS) / sizeof(IPV6_LENGTHS[0]),
+                         generated[1], ipv6Records);
+        report.source = "generated";
+    } else if (!readPrefixes(argv[optind], ipv4Records, ipv6Records)) {
+        cerr << MSG_ERR_FILE_OPEN << argv[optind] << endl;
+        return EXIT_FAILURE;
+    } else {
+        report.source = argv[optind];
+    }
+
+    // Stress test searches generated addresses, rounds are the passes of the writer
+    if (stressReaders != 0) {
+        bool valid = stress<IPv4AddrFamily>("IPv4", ipv4Records, STRESS_IPV4_LENGTH, random, queryCount,
+                                            report.rounds, stressReaders);
+        valid = stress<IPv6AddrFamily>("IPv6", ipv6Records, STRESS_IPV6_LENGTH, random, queryCount,
+                                       report.rounds, stressReaders) && valid;
+        if (!valid) {
+            cerr << MSG_ERR_STRESS << endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    Tables<IPv4AddrFamily> ipv4Tables;
+    Tables<IPv6AddrFamily> ipv6Tables;
+    buildTable("IPv4", "bit", ipv4Tables.trie, ipv4Records, report);
+    buildTable("IPv4", "poptrie", ipv4Tables.poptrie, ipv4Records, report);
+    buildTable("IPv4", "leafpush", ipv4Tables.leafpush, ipv4Records, report);
+    buildTable("IPv6", "bit", ipv6Tables.trie, ipv6Records, report);
+    buildTable("IPv6", "poptrie", ipv6Tables.poptrie, ipv6Records, report);
+    buildTable("IPv6", "leafpush", ipv6Tables.leafpush, ipv6Records, report);
+
+    /* Addresses of both families are prepared in advance, only searching is measured */
+    vector<Queries> ipv4Streams, ipv6Streams;
+    if (positional >= 2) {
+        ipv4Streams.resize(1);
+        ipv6Streams.resize(1);
+        if (!readQueries(argv[optind + 1], ipv4Streams[0], ipv6Streams[0])) {
+            cerr << MSG_ERR_FILE_OPEN << argv[optind + 1] << endl;
+            return EXIT_FAILURE;
+        }
+    } else {
+        generateQueries(random, 1, ipv4Records, queryCount, ipv4Streams);
+        generateQueries(random, 4, ipv6Records, queryCount, ipv6Streams);
+    }
+
+    for (size_t i = 0; i < ipv4Streams.size(); i++) {
+        report.same = measure("IPv4", ipv4Tables, ipv4Streams[i], report) && report.same;
+    }
+    for (size_t i = 0; i < ipv6Streams.size(); i++) {
+        report.same = measure("IPv6", ipv6Tables, ipv6Streams[i], report) && report.same;
+    }
+
+    if (json) {
+        printJson(report);
+    } else {
+        printText(report);
+    }
+
+    if (!report.same) {
+        cerr << MSG_ERR_DIFFERENT_ASNS << endl;
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}